@@ -684,12 +684,10 @@ _dl_close_worker (struct link_map *map, bool force)
 	      __rtld_lock_unlock_recursive (tab->lock);
 	    }
 
-	  /* We can unmap all the maps at once.  We determined the
-	     start address and length when we loaded the object and
-	     the `munmap' call does the rest.  */
-	  DL_UNMAP (imap);
-
-	  /* Finally, unlink the data structure and free it.  */
+	  /* Unlink the data structure.  Unmapping and freeing it is
+	     deferred until the write lock has been dropped, so that
+	     dl_iterate_phdr callers (e.g. the unwinder) do not wait for
+	     the munmap system calls.  */
 #if DL_NNS == 1
 	  /* The assert in the (imap->l_prev == NULL) case gives
 	     the compiler license to warn that NS points outside
@@ -716,6 +714,27 @@ _dl_close_worker (struct link_map *map, bool force)
 	  if (imap->l_next != NULL)
 	    imap->l_next->l_prev = imap->l_prev;
 
+	  /* Clear GL(dl_initfirst) when freeing its link_map memory.  */
+	  if (imap == GL(dl_initfirst))
+	    GL(dl_initfirst) = NULL;
+	}
+    }
+
+  __rtld_lock_unlock_recursive (GL(dl_load_write_lock));
+
+  /* The unused objects are no longer reachable through the namespace
+     list.  We still hold dl_load_lock, so nobody else can look at
+     them; release their memory now.  */
+  for (unsigned int i = first_loaded; i < nloaded; ++i)
+    {
+      struct link_map *imap = maps[i];
+      if (!used[i])
+	{
+	  /* We can unmap all the maps at once.  We determined the
+	     start address and length when we loaded the object and
+	     the `munmap' call does the rest.  */
+	  DL_UNMAP (imap);
+
 	  free (imap->l_versions);
 	  if (imap->l_origin != (char *) -1)
 	    free ((char *) imap->l_origin);
@@ -756,16 +775,10 @@ _dl_close_worker (struct link_map *map, bool force)
 	  if (imap->l_runpath_dirs.dirs != (void *) -1)
 	    free (imap->l_runpath_dirs.dirs);
 
-	  /* Clear GL(dl_initfirst) when freeing its link_map memory.  */
-	  if (imap == GL(dl_initfirst))
-	    GL(dl_initfirst) = NULL;
-
 	  free (imap);
 	}
     }
 
-  __rtld_lock_unlock_recursive (GL(dl_load_write_lock));
-
   /* If we removed any object which uses TLS bump the generation counter.  */
   if (any_tls)
     {
@@ -0,0 +1,72 @@
+/* Memoization of IFUNC resolver results during relocation.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef _DL_IFUNC_CACHE_H
+#define _DL_IFUNC_CACHE_H
+
+#include <link.h>
+
+/* Every object which references an IFUNC symbol, for example memcpy in
+   libc, calls its resolver again during relocation.  The resolvers in
+   libc and ld.so only depend on the CPU features, which do not change
+   during the life of the process, so remember the last result of each
+   of them.  Other objects have l_ifunc_cacheable clear, and their
+   resolvers run for every relocation as before, because they may have
+   side effects or depend on other state.
+
+   The cache is direct-mapped.  An entry is identified by the address of
+   the resolver and the load serial number of the object defining it, so
+   an object which is later mapped at the same address after a dlclose
+   does not see a stale entry.  It is only used during relocation
+   processing, which always runs with dl_load_lock held.  */
+#define DL_IFUNC_CACHE_SIZE 64
+
+struct dl_ifunc_cache_entry
+{
+  ElfW(Addr) resolver;
+  unsigned long long int serial;
+  ElfW(Addr) value;
+};
+
+/* Defined in dl-ifunc-cache.c.  */
+extern struct dl_ifunc_cache_entry _dl_ifunc_cache[DL_IFUNC_CACHE_SIZE]
+  attribute_hidden;
+
+/* Call the IFUNC resolver at RESOLVER, which is defined in MAP, or
+   return the result of an earlier call if MAP allows it.  */
+static inline ElfW(Addr)
+__attribute ((always_inline))
+_dl_ifunc_cache_call (struct link_map *map, ElfW(Addr) resolver)
+{
+  if (!map->l_ifunc_cacheable)
+    return ((ElfW(Addr) (*) (void)) resolver) ();
+
+  struct dl_ifunc_cache_entry *entry
+    = &_dl_ifunc_cache[(resolver / sizeof (ElfW(Addr)))
+		       % DL_IFUNC_CACHE_SIZE];
+  if (entry->resolver == resolver && entry->serial == map->l_serial)
+    return entry->value;
+
+  ElfW(Addr) value = ((ElfW(Addr) (*) (void)) resolver) ();
+  entry->resolver = resolver;
+  entry->serial = map->l_serial;
+  entry->value = value;
+  return value;
+}
+
+#endif /* dl-ifunc-cache.h */
@@ -16,25 +16,57 @@
    License along with the GNU C Library; if not, see
    <https://www.gnu.org/licenses/>.  */
 
+#include <alloca.h>
 #include <stddef.h>
+#include <string.h>
 #include <ldsodefs.h>
+#include <_itoa.h>
 
 
 /* Type of the initializer.  */
 typedef void (*init_t) (int, char **, char **);
 
 
+#if HP_TIMING_INLINE
+/* Emit one JSON line with the timing data collected for L.  */
 static void
-call_init (struct link_map *l, int argc, char **argv, char **env)
+report_timing (struct link_map *l)
 {
-  if (l->l_init_called)
-    /* This object is all done.  */
-    return;
+  const char *name = DSO_FILENAME (l->l_name);
+
+  /* Quote the characters which cannot appear verbatim in a JSON
+     string.  Control characters are simply replaced.  */
+  char *quoted = alloca (2 * strlen (name) + 1);
+  char *cp = quoted;
+  for (; *name != '\0'; ++name)
+    {
+      if (*name == '"' || *name == '\\')
+	*cp++ = '\\';
+      *cp++ = (unsigned char) *name < ' ' ? '?' : *name;
+    }
+  *cp = '\0';
+
+  char map[3 * sizeof (hp_timing_t) + 1];
+  char reloc[3 * sizeof (hp_timing_t) + 1];
+  char init[3 * sizeof (hp_timing_t) + 1];
+  map[sizeof (map) - 1] = reloc[sizeof (reloc) - 1]
+    = init[sizeof (init) - 1] = '\0';
+
+  _dl_dprintf (GLRO(dl_debug_fd),
+	       "{\"event\":\"object\",\"name\":\"%s\",\"ns\":%lu,"
+	       "\"map_cycles\":%s,\"reloc_cycles\":%s,"
+	       "\"init_cycles\":%s}\n",
+	       quoted, (unsigned long int) l->l_ns,
+	       _itoa (l->l_map_time, &map[sizeof (map) - 1], 10, 0),
+	       _itoa (l->l_reloc_time, &reloc[sizeof (reloc) - 1], 10, 0),
+	       _itoa (l->l_init_time, &init[sizeof (init) - 1], 10, 0));
+}
+#endif
 
-  /* Avoid handling this constructor again in case we have a circular
-     dependency.  */
-  l->l_init_called = 1;
 
+static void
+call_init_functions (struct link_map *l, int argc, char **argv, char **env)
+{
   /* Check for object which constructors we do not run here.  */
   if (__builtin_expect (l->l_name[0], 'a') == '\0'
       && l->l_type == lt_executable)
@@ -74,6 +106,35 @@ call_init (struct link_map *l, int argc, char **argv, char **env)
 }
 
 
+static void
+call_init (struct link_map *l, int argc, char **argv, char **env)
+{
+  if (l->l_init_called)
+    /* This object is all done.  */
+    return;
+
+  /* Avoid handling this constructor again in case we have a circular
+     dependency.  */
+  l->l_init_called = 1;
+
+#if HP_TIMING_INLINE
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_TIMING))
+    {
+      hp_timing_t start;
+      hp_timing_t end;
+      HP_TIMING_NOW (start);
+      call_init_functions (l, argc, argv, env);
+      HP_TIMING_NOW (end);
+      HP_TIMING_DIFF (l->l_init_time, start, end);
+      report_timing (l);
+      return;
+    }
+#endif
+
+  call_init_functions (l, argc, argv, env);
+}
+
+
 void
 _dl_init (struct link_map *main_map, int argc, char **argv, char **env)
 {
@@ -74,6 +74,7 @@ struct filebuf
 #include <not-cancel.h>
 
 #include <endian.h>
+#include <gnu/lib-names.h>
 #if BYTE_ORDER == BIG_ENDIAN
 # define byteorder ELFDATA2MSB
 #elif BYTE_ORDER == LITTLE_ENDIAN
@@ -1367,6 +1368,12 @@ cannot enable executable stack as shared object requires");
   assert (origname == NULL);
 #endif
 
+  /* The IFUNC resolvers of libc only depend on the CPU features.  */
+  if (l->l_info[DT_SONAME] != NULL
+      && strcmp ((const char *) D_PTR (l, l_info[DT_STRTAB])
+		 + l->l_info[DT_SONAME]->d_un.d_val, LIBC_SO) == 0)
+    l->l_ifunc_cacheable = 1;
+
   /* When we profile the SONAME might be needed for something else but
      loading.  Add it right away.  */
   if (__glibc_unlikely (GLRO(dl_profile) != NULL)
@@ -1916,6 +1923,9 @@ _dl_map_object (struct link_map *loader, const char *name,
   char *name_copy;
   struct link_map *l;
   struct filebuf fb;
+#if HP_TIMING_INLINE
+  hp_timing_t map_start = 0;
+#endif
 
   assert (nsid >= 0);
   assert (nsid < GL(dl_nns));
@@ -1994,6 +2004,11 @@ _dl_map_object (struct link_map *loader, const char *name,
     }
 #endif
 
+#if HP_TIMING_INLINE
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_TIMING))
+    HP_TIMING_NOW (map_start);
+#endif
+
   /* Will be true if we found a DSO which is of the other ELF class.  */
   bool found_other_class = false;
 
@@ -2215,8 +2230,22 @@ _dl_map_object (struct link_map *loader, const char *name,
     }
 
   void *stack_end = __libc_stack_end;
-  return _dl_map_object_from_fd (name, origname, fd, &fb, realname, loader,
-				 type, mode, &stack_end, nsid);
+  l = _dl_map_object_from_fd (name, origname, fd, &fb, realname, loader,
+			      type, mode, &stack_end, nsid);
+
+#if HP_TIMING_INLINE
+  /* Charge the search and the mapping to the object, unless it turned
+     out to be an object we had already loaded.  */
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_TIMING)
+      && l->l_map_time == 0)
+    {
+      hp_timing_t map_end;
+      HP_TIMING_NOW (map_end);
+      HP_TIMING_DIFF (l->l_map_time, map_start, map_end);
+    }
+#endif
+
+  return l;
 }
 
 struct add_path_state
@@ -157,6 +157,9 @@ _dl_relocate_object (struct link_map *l, struct r_scope_elem *scope[],
   const char *errstring = NULL;
   int lazy = reloc_mode & RTLD_LAZY;
   int skip_ifunc = reloc_mode & __RTLD_NOIFUNC;
+#if HP_TIMING_INLINE
+  hp_timing_t reloc_start = 0;
+#endif
 
 #ifdef SHARED
   /* If we are auditing, install the same handlers we need for profiling.  */
@@ -181,6 +184,11 @@ _dl_relocate_object (struct link_map *l, struct r_scope_elem *scope[],
     _dl_debug_printf ("\nrelocation processing: %s%s\n",
 		      DSO_FILENAME (l->l_name), lazy ? " (lazy)" : "");
 
+#if HP_TIMING_INLINE
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_TIMING))
+    HP_TIMING_NOW (reloc_start);
+#endif
+
   /* DT_TEXTREL is now in level 2 and might phase out at some time.
      But we rewrite the DT_FLAGS entry to a DT_TEXTREL entry to make
      testing easier and therefore it will be available at all time.  */
@@ -301,6 +309,15 @@ _dl_relocate_object (struct link_map *l, struct r_scope_elem *scope[],
      done, do it.  */
   if (l->l_relro_size != 0)
     _dl_protect_relro (l);
+
+#if HP_TIMING_INLINE
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_TIMING))
+    {
+      hp_timing_t reloc_end;
+      HP_TIMING_NOW (reloc_end);
+      HP_TIMING_DIFF (l->l_reloc_time, reloc_start, reloc_end);
+    }
+#endif
 }
 
 
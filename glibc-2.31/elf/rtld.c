@@ -48,6 +48,11 @@
 
 #include <assert.h>
 
+#if HAVE_TUNABLES
+# define TUNABLE_NAMESPACE rtld
+# include <dl-tunables.h>
+#endif
+
 /* Only enables rtld profiling for architectures which provides non generic
    hp-timing support.  The generic support requires either syscall
    (clock_gettime), which will incur in extra overhead on loading time.
@@ -109,6 +114,9 @@ static void print_missing_version (int errcode, const char *objname,
 /* Print the various times we collected.  */
 static void print_statistics (const hp_timing_t *total_timep);
 
+/* Print the glibc.rtld.timing_report summary line.  */
+static void print_timing_report (const hp_timing_t *total_timep);
+
 /* Add audit objects.  */
 static void process_dl_audit (char *str);
 
@@ -429,6 +437,7 @@ _dl_start_final (void *arg, struct dl_start_final_info *info)
 #endif
   _dl_setup_hash (&GL(dl_rtld_map));
   GL(dl_rtld_map).l_real = &GL(dl_rtld_map);
+  GL(dl_rtld_map).l_ifunc_cacheable = 1;
   GL(dl_rtld_map).l_map_start = (ElfW(Addr)) _begin;
   GL(dl_rtld_map).l_map_end = (ElfW(Addr)) _end;
   GL(dl_rtld_map).l_text_end = (ElfW(Addr)) _etext;
@@ -448,11 +457,15 @@ _dl_start_final (void *arg, struct dl_start_final_info *info)
      entry point on the same stack we entered on.  */
   start_addr = _dl_sysdep_start (arg, &dl_main);
 
-  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_STATISTICS))
+  if (__glibc_unlikely (GLRO(dl_debug_mask)
+			& (DL_DEBUG_STATISTICS | DL_DEBUG_TIMING)))
     {
       RTLD_TIMING_VAR (rtld_total_time);
       rtld_timer_stop (&rtld_total_time, start_time);
-      print_statistics (RTLD_TIMING_REF(rtld_total_time));
+      if (GLRO(dl_debug_mask) & DL_DEBUG_STATISTICS)
+	print_statistics (RTLD_TIMING_REF(rtld_total_time));
+      if (GLRO(dl_debug_mask) & DL_DEBUG_TIMING)
+	print_timing_report (RTLD_TIMING_REF(rtld_total_time));
     }
 
   return start_addr;
@@ -2697,6 +2710,16 @@ process_envvars (enum mode *modep)
   /* The caller wants this information.  */
   *modep = mode;
 
+#if HAVE_TUNABLES && HP_TIMING_INLINE
+  /* The per-object timing report shares the debug output channel.  It
+     needs the hardware timer, see RLTD_TIMING_DECLARE above.  */
+  if (TUNABLE_GET (timing_report, int32_t, NULL) != 0)
+    {
+      GLRO(dl_debug_mask) |= DL_DEBUG_TIMING;
+      any_debug = 1;
+    }
+#endif
+
   /* Extra security for SUID binaries.  Remove all dangerous environment
      variables.  */
   if (__builtin_expect (__libc_enable_secure, 0))
@@ -2840,3 +2863,30 @@ print_statistics (const hp_timing_t *rtld_total_timep)
 			 load_time, *rtld_total_timep);
 #endif
 }
+
+/* Print the startup totals of the timing report as one JSON line.  The
+   per-object lines are printed by _dl_init once the constructors of an
+   object have run.  */
+static void
+__attribute ((noinline))
+print_timing_report (const hp_timing_t *rtld_total_timep)
+{
+#if HP_TIMING_INLINE
+  char total[3 * sizeof (hp_timing_t) + 1];
+  char load[3 * sizeof (hp_timing_t) + 1];
+  char reloc[3 * sizeof (hp_timing_t) + 1];
+  total[sizeof (total) - 1] = load[sizeof (load) - 1]
+    = reloc[sizeof (reloc) - 1] = '\0';
+
+  _dl_dprintf (GLRO(dl_debug_fd),
+	       "{\"event\":\"rtld\",\"total_cycles\":%s,\"load_cycles\":%s,"
+	       "\"reloc_cycles\":%s,\"objects\":%u,\"relocations\":%lu,"
+	       "\"cache_relocations\":%lu}\n",
+	       _itoa (*rtld_total_timep, &total[sizeof (total) - 1], 10, 0),
+	       _itoa (load_time, &load[sizeof (load) - 1], 10, 0),
+	       _itoa (relocate_time, &reloc[sizeof (reloc) - 1], 10, 0),
+	       GL(dl_ns)[LM_ID_BASE]._ns_nloaded,
+	       GL(dl_num_relocations),
+	       GL(dl_num_cache_relocations));
+#endif
+}
@@ -56,6 +56,11 @@ BUILTIN_TRANSFORMATION ("ISO-10646/UTF8/", "INTERNAL", 1, "=utf8->INTERNAL",
 			__gconv_transform_utf8_internal, __gconv_btwoc_ascii,
 			1, 6, 4, 4)
 
+/* Direct conversion which avoids the detour through INTERNAL.  The
+   reverse direction needs INTERNAL for transliteration.  */
+BUILTIN_TRANSFORMATION ("ISO-8859-1//", "ISO-10646/UTF8/", 1, "=latin1->utf8",
+			__gconv_transform_latin1_utf8, NULL, 1, 1, 1, 2)
+
 BUILTIN_ALIAS ("UCS2//", "ISO-10646/UCS2/")
 BUILTIN_ALIAS ("UCS-2//", "ISO-10646/UCS2/")
 BUILTIN_ALIAS ("OSF00010100//", "ISO-10646/UCS2/") /* level 1 */
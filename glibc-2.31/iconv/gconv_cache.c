@@ -36,6 +36,26 @@ static void *gconv_cache;
 static size_t cache_size;
 static int cache_malloced;
 
+/* The step arrays handed out by __gconv_lookup_cache are kept around
+   after the last user is gone, so that opening the same conversion
+   again does not have to allocate and initialize the steps and load
+   the modules once more.  The array itself holds one reference on
+   every step which uses a module; USERS counts the descriptors which
+   currently use the array.  All accesses happen with __gconv_lock
+   held.  */
+#define NSTEPS_CACHED 16
+
+struct cached_steps
+{
+  size_t fromidx;
+  size_t toidx;
+  struct __gconv_step *steps;
+  size_t nsteps;
+  unsigned int users;
+};
+
+static struct cached_steps cached_steps[NSTEPS_CACHED];
+
 
 void *
 __gconv_get_cache (void)
@@ -242,6 +262,78 @@ __gconv_compare_alias_cache (const char *name1, const char *name2, int *result)
 }
 
 
+/* Look for a step array for the conversion from FROMIDX to TOIDX which
+   was set up before.  */
+static int
+find_cached_steps (size_t fromidx, size_t toidx,
+		   struct __gconv_step **handle, size_t *nsteps)
+{
+  for (size_t cnt = 0; cnt < NSTEPS_CACHED; ++cnt)
+    {
+      struct cached_steps *entry = &cached_steps[cnt];
+
+      if (entry->steps != NULL && entry->fromidx == fromidx
+	  && entry->toidx == toidx)
+	{
+	  /* The reference held by the array keeps the modules loaded
+	     and initialized, so just count the new user.  */
+	  for (size_t idx = 0; idx < entry->nsteps; ++idx)
+	    if (entry->steps[idx].__shlib_handle != NULL)
+	      ++entry->steps[idx].__counter;
+	  ++entry->users;
+
+	  *handle = entry->steps;
+	  *nsteps = entry->nsteps;
+	  return 1;
+	}
+    }
+
+  return 0;
+}
+
+
+/* Remember the step array STEPS for later calls.  If all slots are
+   used by active descriptors the array is not cached.  */
+static void
+add_cached_steps (size_t fromidx, size_t toidx,
+		  struct __gconv_step *steps, size_t nsteps)
+{
+  struct cached_steps *entry = NULL;
+
+  for (size_t cnt = 0; cnt < NSTEPS_CACHED; ++cnt)
+    if (cached_steps[cnt].steps == NULL)
+      {
+	entry = &cached_steps[cnt];
+	break;
+      }
+    else if (cached_steps[cnt].users == 0 && entry == NULL)
+      entry = &cached_steps[cnt];
+
+  if (entry == NULL)
+    return;
+
+  if (entry->steps != NULL)
+    {
+      /* Evict the unused array.  */
+#ifndef STATIC_GCONV
+      for (size_t idx = 0; idx < entry->nsteps; ++idx)
+	__gconv_release_step (&entry->steps[idx]);
+#endif
+      free (entry->steps);
+    }
+
+  for (size_t idx = 0; idx < nsteps; ++idx)
+    if (steps[idx].__shlib_handle != NULL)
+      ++steps[idx].__counter;
+
+  entry->fromidx = fromidx;
+  entry->toidx = toidx;
+  entry->steps = steps;
+  entry->nsteps = nsteps;
+  entry->users = 1;
+}
+
+
 int
 __gconv_lookup_cache (const char *toset, const char *fromset,
 		      struct __gconv_step **handle, size_t *nsteps, int flags)
@@ -280,6 +372,9 @@ __gconv_lookup_cache (const char *toset, const char *fromset,
   if (__builtin_expect (flags & GCONV_AVOID_NOCONV, 0) && fromidx == toidx)
     return __GCONV_NULCONV;
 
+  if (find_cached_steps (fromidx, toidx, handle, nsteps))
+    return __GCONV_OK;
+
   /* If there are special conversions available examine them first.  */
   if (fromidx != 0 && toidx != 0
       && __builtin_expect (from_module->extra_offset, 0) != 0)
@@ -350,6 +445,7 @@ __gconv_lookup_cache (const char *toset, const char *fromset,
 	    }
 	  while (++idx < extra->module_cnt);
 
+	  add_cached_steps (fromidx, toidx, result, *nsteps);
 	  return __GCONV_OK;
 	}
     }
@@ -438,6 +534,7 @@ __gconv_lookup_cache (const char *toset, const char *fromset,
       ++*nsteps;
     }
 
+  add_cached_steps (fromidx, toidx, result, *nsteps);
   return __GCONV_OK;
 }
 
@@ -447,15 +544,39 @@ void
 __gconv_release_cache (struct __gconv_step *steps, size_t nsteps)
 {
   if (gconv_cache != NULL)
-    /* The only thing we have to deallocate is the record with the
-       steps.  */
-    free (steps);
+    {
+      /* Arrays which are cached stay around for the next user.  */
+      for (size_t cnt = 0; cnt < NSTEPS_CACHED; ++cnt)
+	if (cached_steps[cnt].steps == steps)
+	  {
+	    --cached_steps[cnt].users;
+	    return;
+	  }
+
+      /* The only thing we have to deallocate is the record with the
+	 steps.  */
+      free (steps);
+    }
 }
 
 
 /* Free all resources if necessary.  */
 libc_freeres_fn (free_mem)
 {
+  /* Drop the references the unused arrays hold on their modules
+     before gconv_dl.c unloads all modules.  */
+  for (size_t cnt = 0; cnt < NSTEPS_CACHED; ++cnt)
+    if (cached_steps[cnt].steps != NULL && cached_steps[cnt].users == 0)
+      {
+#ifndef STATIC_GCONV
+	for (size_t idx = 0; idx < cached_steps[cnt].nsteps; ++idx)
+	  __gconv_release_step (&cached_steps[cnt].steps[idx]);
+#endif
+	free (cached_steps[cnt].steps);
+	cached_steps[cnt].steps = NULL;
+	cached_steps[cnt].nsteps = 0;
+      }
+
   if (cache_malloced)
     free (gconv_cache);
 #ifdef _POSIX_MAPPED_FILES
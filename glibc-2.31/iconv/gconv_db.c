@@ -795,9 +795,8 @@ __gconv_close_transform (struct __gconv_step *steps, size_t nsteps)
     __gconv_release_step (&steps[cnt]);
 #endif
 
-  /* If we use the cache we free a bit more since we don't keep any
-     transformation records around, they are cheap enough to
-     recreate.  */
+  /* If we use the cache the transformation record is either kept for
+     the next user or freed.  */
   __gconv_release_cache (steps, nsteps);
 
   /* Release the lock.  */
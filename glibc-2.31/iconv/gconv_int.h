@@ -252,6 +252,7 @@ __BUILTIN_TRANSFORM (__gconv_transform_ascii_internal);
 __BUILTIN_TRANSFORM (__gconv_transform_internal_ascii);
 __BUILTIN_TRANSFORM (__gconv_transform_utf8_internal);
 __BUILTIN_TRANSFORM (__gconv_transform_internal_utf8);
+__BUILTIN_TRANSFORM (__gconv_transform_latin1_utf8);
 __BUILTIN_TRANSFORM (__gconv_transform_ucs2_internal);
 __BUILTIN_TRANSFORM (__gconv_transform_internal_ucs2);
 __BUILTIN_TRANSFORM (__gconv_transform_ucs2reverse_internal);
@@ -877,6 +877,74 @@ ucs4le_internal_loop_single (struct __gconv_step *step,
 #include <iconv/skeleton.c>
 
 
+/* Most text passed through the UTF-8 converters is ASCII.  The
+   following functions convert the longest run of ASCII characters at
+   the start of the buffer a word at a time, so the per-character loop
+   body only has to deal with multibyte sequences, errors and the
+   buffer boundaries.  They never consume more than fits into the
+   output buffer.  */
+#define ASCII_HIGH_BITS ((~0UL / 0xff) * 0x80)
+
+static inline void
+__attribute ((always_inline))
+utf8_internal_ascii_run (const unsigned char **inptrp,
+			 const unsigned char *inend,
+			 unsigned char **outptrp, const unsigned char *outend)
+{
+  const unsigned char *inptr = *inptrp;
+  unsigned char *outptr = *outptrp;
+  size_t n = MIN ((size_t) (inend - inptr),
+		  (size_t) (outend - outptr) / sizeof (uint32_t));
+
+  while (n >= sizeof (unsigned long int))
+    {
+      unsigned long int w;
+      memcpy (&w, inptr, sizeof (w));
+      if ((w & ASCII_HIGH_BITS) != 0)
+	break;
+
+      for (size_t i = 0; i < sizeof (w); ++i)
+	((uint32_t *) outptr)[i] = inptr[i];
+      inptr += sizeof (w);
+      outptr += sizeof (w) * sizeof (uint32_t);
+      n -= sizeof (w);
+    }
+
+  *inptrp = inptr;
+  *outptrp = outptr;
+}
+
+static inline void
+__attribute ((always_inline))
+internal_utf8_ascii_run (const unsigned char **inptrp,
+			 const unsigned char *inend,
+			 unsigned char **outptrp, const unsigned char *outend)
+{
+  const unsigned char *inptr = *inptrp;
+  unsigned char *outptr = *outptrp;
+  size_t n = MIN ((size_t) (inend - inptr) / sizeof (uint32_t),
+		  (size_t) (outend - outptr));
+
+  while (n >= 4)
+    {
+      const uint32_t *wc = (const uint32_t *) inptr;
+      if (((wc[0] | wc[1] | wc[2] | wc[3]) & ~(uint32_t) 0x7f) != 0)
+	break;
+
+      outptr[0] = wc[0];
+      outptr[1] = wc[1];
+      outptr[2] = wc[2];
+      outptr[3] = wc[3];
+      inptr += 4 * sizeof (uint32_t);
+      outptr += 4;
+      n -= 4;
+    }
+
+  *inptrp = inptr;
+  *outptrp = outptr;
+}
+
+
 /* Convert from the internal (UCS4-like) format to UTF-8.  */
 #define DEFINE_INIT		0
 #define DEFINE_FINI		0
@@ -898,8 +966,14 @@ ucs4le_internal_loop_single (struct __gconv_step *step,
     uint32_t wc = *((const uint32_t *) inptr);				      \
 									      \
     if (__glibc_likely (wc < 0x80))					      \
-      /* It's an one byte sequence.  */					      \
-      *outptr++ = (unsigned char) wc;					      \
+      {									      \
+	/* It's an one byte sequence.  Handle the ASCII characters which      \
+	   follow in bulk.  */						      \
+	*outptr++ = (unsigned char) wc;					      \
+	inptr += 4;							      \
+	internal_utf8_ascii_run (&inptr, inend, &outptr, outend);	      \
+	continue;							      \
+      }									      \
     else if (__glibc_likely (wc <= 0x7fffffff				      \
 			     && (wc < 0xd800 || wc > 0xdfff)))		      \
       {									      \
@@ -963,8 +1037,13 @@ ucs4le_internal_loop_single (struct __gconv_step *step,
 									      \
     if (__glibc_likely (ch < 0x80))					      \
       {									      \
-	/* One byte sequence.  */					      \
+	/* One byte sequence.  Handle the ASCII characters which follow       \
+	   in bulk.  */							      \
 	++inptr;							      \
+	*((uint32_t *) outptr) = ch;					      \
+	outptr += sizeof (uint32_t);					      \
+	utf8_internal_ascii_run (&inptr, inend, &outptr, outend);	      \
+	continue;							      \
       }									      \
     else								      \
       {									      \
@@ -1161,6 +1240,50 @@ ucs4le_internal_loop_single (struct __gconv_step *step,
 #include <iconv/skeleton.c>
 
 
+/* Convert from ISO 8859-1 directly to UTF-8.  Every ISO 8859-1 byte is
+   the Unicode character with the same value, so there is no need to go
+   through the internal format and no input can be invalid.  */
+#define DEFINE_INIT		0
+#define DEFINE_FINI		0
+#define MIN_NEEDED_FROM		1
+#define MIN_NEEDED_TO		1
+#define MAX_NEEDED_TO		2
+#define FROM_DIRECTION		1
+#define FROM_LOOP		latin1_utf8_loop
+#define TO_LOOP			latin1_utf8_loop /* This is not used.  */
+#define FUNCTION_NAME		__gconv_transform_latin1_utf8
+#define ONE_DIRECTION		1
+
+#define MIN_NEEDED_INPUT	MIN_NEEDED_FROM
+#define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
+#define MAX_NEEDED_OUTPUT	MAX_NEEDED_TO
+#define LOOPFCT			FROM_LOOP
+#define BODY \
+  {									      \
+    uint32_t ch = *inptr;						      \
+									      \
+    if (__glibc_likely (ch < 0x80))					      \
+      /* It's an one byte sequence.  */					      \
+      *outptr++ = (unsigned char) ch;					      \
+    else								      \
+      {									      \
+	if (__glibc_unlikely (outptr + 2 > outend))			      \
+	  {								      \
+	    /* Too long.  */						      \
+	    result = __GCONV_FULL_OUTPUT;				      \
+	    break;							      \
+	  }								      \
+									      \
+	*outptr++ = 0xc0 | (ch >> 6);					      \
+	*outptr++ = 0x80 | (ch & 0x3f);					      \
+      }									      \
+									      \
+    ++inptr;								      \
+  }
+#include <iconv/loop.c>
+#include <iconv/skeleton.c>
+
+
 /* Convert from UCS2 to the internal (UCS4-like) format.  */
 #define DEFINE_INIT		0
 #define DEFINE_FINI		0
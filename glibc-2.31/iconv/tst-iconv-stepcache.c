@@ -0,0 +1,165 @@
+/* Test reuse and eviction of cached step arrays with loaded modules.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <iconv.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <support/capture_subprocess.h>
+#include <support/check.h>
+#include <support/support.h>
+
+/* Step arrays are only cached for conversions found in
+   gconv-modules.cache.  The test runs in a container, so that it can
+   generate the cache for the installed modules, and without
+   GCONV_PATH, which disables the cache.  */
+
+struct sample
+{
+  const char *charset;
+  const char *utf8;
+  const char *encoded;
+};
+
+/* Each charset is implemented by a module.  With two directions per
+   charset there are more conversions than cached step arrays.  */
+static const struct sample samples[] =
+  {
+    { "ISO-8859-1", "\xc3\xa9", "\xe9" },
+    { "ISO-8859-2", "\xc5\x82", "\xb3" },
+    { "ISO-8859-3", "\xc4\xa7", "\xb1" },
+    { "ISO-8859-4", "\xc4\xb8", "\xa2" },
+    { "ISO-8859-5", "\xd0\x96", "\xb6" },
+    { "ISO-8859-6", "\xd8\xa1", "\xc1" },
+    { "ISO-8859-7", "\xce\xb1", "\xe1" },
+    { "ISO-8859-8", "\xd7\x90", "\xe0" },
+    { "ISO-8859-9", "\xc4\x9f", "\xf0" },
+    { "ISO-8859-10", "\xc4\x81", "\xe0" },
+    { "ISO-8859-13", "\xc4\x81", "\xe2" },
+    { "ISO-8859-14", "\xc5\xb5", "\xf0" },
+    { "ISO-8859-15", "\xe2\x82\xac", "\xa4" },
+    { "ISO-8859-16", "\xe2\x82\xac", "\xa4" },
+    { "KOI8-R", "\xd0\x96", "\xf6" },
+    { "CP1251", "\xd0\x96", "\xc6" },
+    { "CP1252", "\xe2\x82\xac", "\x80" },
+    { "EUC-JP", "\xe3\x81\x82", "\xa4\xa2" },
+    { "EUC-KR", "\xea\xb0\x80", "\xb0\xa1" },
+  };
+#define NSAMPLES (sizeof (samples) / sizeof (samples[0]))
+
+/* Convert "<" IN ">" with CD and compare the result with "<" EXPECTED
+   ">".  */
+static void
+check_conversion (iconv_t cd, const char *in, const char *expected,
+		  const char *what)
+{
+  char *input = xasprintf ("<%s>", in);
+  char *inptr = input;
+  size_t inlen = strlen (input);
+  char output[64];
+  char *outptr = output;
+  size_t outlen = sizeof (output);
+
+  if (iconv (cd, &inptr, &inlen, &outptr, &outlen) == (size_t) -1)
+    FAIL_EXIT1 ("iconv (%s): %m", what);
+  TEST_COMPARE (inlen, 0);
+
+  char *expected_output = xasprintf ("<%s>", expected);
+  TEST_COMPARE_BLOB (output, outptr - output,
+		     expected_output, strlen (expected_output));
+  free (expected_output);
+  free (input);
+}
+
+static iconv_t
+xiconv_open (const char *to, const char *from)
+{
+  iconv_t cd = iconv_open (to, from);
+  if (cd == (iconv_t) -1)
+    FAIL_EXIT1 ("iconv_open (\"%s\", \"%s\"): %m", to, from);
+  return cd;
+}
+
+/* Open, use and close both conversions of SAMPLE.  */
+static void
+check_sample (const struct sample *sample)
+{
+  iconv_t to = xiconv_open (sample->charset, "UTF-8");
+  check_conversion (to, sample->utf8, sample->encoded, sample->charset);
+  TEST_COMPARE (iconv_close (to), 0);
+
+  iconv_t from = xiconv_open ("UTF-8", sample->charset);
+  check_conversion (from, sample->encoded, sample->utf8, sample->charset);
+  TEST_COMPARE (iconv_close (from), 0);
+}
+
+static int
+do_test (void)
+{
+  unsetenv ("GCONV_PATH");
+
+  /* Generate gconv-modules.cache for the installed modules.  */
+  char *iconvconfig = xasprintf ("%s/iconvconfig", support_sbindir_prefix);
+  char *args[] = { iconvconfig, NULL };
+  struct support_capture_subprocess result
+    = support_capture_subprogram (iconvconfig, args);
+  support_capture_subprocess_check (&result, "iconvconfig", 0,
+				    sc_allow_none);
+  support_capture_subprocess_free (&result);
+  free (iconvconfig);
+
+  struct stat64 st;
+  TEST_COMPARE (stat64 (GCONV_DIR "/gconv-modules.cache", &st), 0);
+
+  /* Cycle through all conversions several times, so that the cached
+     arrays are evicted and set up again.  */
+  for (int round = 0; round < 3; ++round)
+    for (size_t i = 0; i < NSAMPLES; ++i)
+      check_sample (&samples[i]);
+
+  /* Keep more descriptors open than there are cache slots, then use a
+     conversion which was cached before and one which was not.  */
+  iconv_t open_cds[NSAMPLES];
+  for (size_t i = 0; i < NSAMPLES; ++i)
+    open_cds[i] = xiconv_open (samples[i].charset, "UTF-8");
+  check_sample (&samples[0]);
+  check_sample (&samples[NSAMPLES - 1]);
+  for (size_t i = 0; i < NSAMPLES; ++i)
+    {
+      check_conversion (open_cds[i], samples[i].utf8, samples[i].encoded,
+			samples[i].charset);
+      TEST_COMPARE (iconv_close (open_cds[i]), 0);
+    }
+
+  /* The same conversion used by several descriptors at once, before
+     and after it is evicted.  */
+  for (int round = 0; round < 2; ++round)
+    {
+      iconv_t cd1 = xiconv_open ("EUC-JP", "UTF-8");
+      iconv_t cd2 = xiconv_open ("EUC-JP", "UTF-8");
+      TEST_COMPARE (iconv_close (cd1), 0);
+      for (size_t i = 0; i < NSAMPLES; ++i)
+	check_sample (&samples[i]);
+      check_conversion (cd2, "\xe3\x81\x82", "\xa4\xa2", "EUC-JP");
+      TEST_COMPARE (iconv_close (cd2), 0);
+    }
+
+  return 0;
+}
+
+#include <support/test-driver.c>
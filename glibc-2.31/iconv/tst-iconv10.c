@@ -0,0 +1,84 @@
+/* Test the conversion from ISO-8859-1 to UTF-8.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <iconv.h>
+#include <string.h>
+#include <support/check.h>
+
+static int
+do_test (void)
+{
+  char latin1[256];
+  char utf8[2 * 256];
+  size_t utf8_len = 0;
+
+  for (int c = 0; c < 256; ++c)
+    {
+      latin1[c] = c;
+      if (c < 0x80)
+	utf8[utf8_len++] = c;
+      else
+	{
+	  utf8[utf8_len++] = 0xc0 | (c >> 6);
+	  utf8[utf8_len++] = 0x80 | (c & 0x3f);
+	}
+    }
+
+  iconv_t cd = iconv_open ("UTF-8", "LATIN1");
+  TEST_VERIFY_EXIT (cd != (iconv_t) -1);
+
+  /* Use every output buffer size, so that two byte sequences do not
+     fit at the end of the buffer in some of the calls.  */
+  for (size_t chunk = 2; chunk <= sizeof (utf8); ++chunk)
+    {
+      char out[sizeof (utf8)];
+      char *inptr = latin1;
+      size_t inlen = sizeof (latin1);
+      char *outptr = out;
+
+      while (inlen > 0)
+	{
+	  size_t outlen = chunk;
+	  if (iconv (cd, &inptr, &inlen, &outptr, &outlen) == (size_t) -1)
+	    TEST_COMPARE (errno, E2BIG);
+	}
+
+      TEST_COMPARE_BLOB (out, outptr - out, utf8, utf8_len);
+    }
+
+  TEST_VERIFY_EXIT (iconv_close (cd) == 0);
+
+  /* The reverse direction still works, including transliteration of
+     characters not in ISO-8859-1.  */
+  cd = iconv_open ("LATIN1//TRANSLIT", "UTF-8");
+  TEST_VERIFY_EXIT (cd != (iconv_t) -1);
+  char in2[] = "caf\xc3\xa9 \xe2\x80\x9cquoted\xe2\x80\x9d";
+  char *inptr = in2;
+  size_t inlen = strlen (in2);
+  char out2[64];
+  char *outptr = out2;
+  size_t outlen = sizeof (out2);
+  TEST_VERIFY (iconv (cd, &inptr, &inlen, &outptr, &outlen) != (size_t) -1);
+  TEST_COMPARE_BLOB (out2, outptr - out2, "caf\xe9 \"quoted\"", 13);
+  TEST_VERIFY_EXIT (iconv_close (cd) == 0);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,134 @@
+/* Test UTF-8 conversion of ASCII runs across buffer boundaries.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <iconv.h>
+#include <string.h>
+#include <wchar.h>
+#include <support/check.h>
+
+/* Build a string of ASCII runs of every length up to 40, separated by
+   two and three byte sequences.  */
+static char utf8[4096];
+static wchar_t wide[2048];
+static size_t utf8_len;
+static size_t wide_len;
+
+static void
+init_input (void)
+{
+  for (int run = 0; run <= 40; ++run)
+    {
+      for (int i = 0; i < run; ++i)
+	{
+	  char c = 'a' + (run + i) % 26;
+	  utf8[utf8_len++] = c;
+	  wide[wide_len++] = c;
+	}
+      if (run % 2 == 0)
+	{
+	  /* U+00E9.  */
+	  utf8[utf8_len++] = '\xc3';
+	  utf8[utf8_len++] = '\xa9';
+	  wide[wide_len++] = 0xe9;
+	}
+      else
+	{
+	  /* U+20AC.  */
+	  utf8[utf8_len++] = '\xe2';
+	  utf8[utf8_len++] = '\x82';
+	  utf8[utf8_len++] = '\xac';
+	  wide[wide_len++] = 0x20ac;
+	}
+    }
+}
+
+/* Convert INLEN bytes at IN with CD, using an output buffer of CHUNK
+   bytes at a time, and store the result in OUT.  Return the number of
+   bytes written.  */
+static size_t
+convert (iconv_t cd, const char *in, size_t inlen, char *out, size_t chunk)
+{
+  char *inptr = (char *) in;
+  char *outptr = out;
+
+  while (inlen > 0)
+    {
+      size_t outlen = chunk;
+      char *start = outptr;
+      size_t n = iconv (cd, &inptr, &inlen, &outptr, &outlen);
+      if (n == (size_t) -1)
+	{
+	  TEST_COMPARE (errno, E2BIG);
+	  /* Some progress must be made unless the buffer is too small
+	     for the next character.  */
+	  if (outptr == start)
+	    TEST_VERIFY_EXIT (chunk < 3 * sizeof (wchar_t));
+	}
+    }
+  return outptr - out;
+}
+
+static int
+do_test (void)
+{
+  init_input ();
+
+  iconv_t to_wide = iconv_open ("WCHAR_T", "UTF-8");
+  TEST_VERIFY_EXIT (to_wide != (iconv_t) -1);
+  iconv_t from_wide = iconv_open ("UTF-8", "WCHAR_T");
+  TEST_VERIFY_EXIT (from_wide != (iconv_t) -1);
+
+  for (size_t chunk = sizeof (wchar_t); chunk <= 64 * sizeof (wchar_t);
+       chunk += sizeof (wchar_t))
+    {
+      wchar_t wbuf[2048];
+      size_t n = convert (to_wide, utf8, utf8_len, (char *) wbuf, chunk);
+      TEST_COMPARE (n, wide_len * sizeof (wchar_t));
+      TEST_VERIFY (wmemcmp (wbuf, wide, wide_len) == 0);
+    }
+
+  for (size_t chunk = 3; chunk <= 64; ++chunk)
+    {
+      char buf[4096];
+      size_t n = convert (from_wide, (const char *) wide,
+			  wide_len * sizeof (wchar_t), buf, chunk);
+      TEST_COMPARE (n, utf8_len);
+      TEST_VERIFY (memcmp (buf, utf8, utf8_len) == 0);
+    }
+
+  /* An invalid byte after a long ASCII run is reported at the right
+     position.  */
+  char bad[] = "0123456789abcdefghij\xff" "klm";
+  char *inptr = bad;
+  size_t inlen = strlen (bad);
+  wchar_t wbuf[64];
+  char *outptr = (char *) wbuf;
+  size_t outlen = sizeof (wbuf);
+  TEST_COMPARE (iconv (to_wide, &inptr, &inlen, &outptr, &outlen),
+		(size_t) -1);
+  TEST_COMPARE (errno, EILSEQ);
+  TEST_COMPARE (inptr - bad, 20);
+  TEST_COMPARE ((outptr - (char *) wbuf) / sizeof (wchar_t), 20);
+
+  TEST_VERIFY_EXIT (iconv_close (to_wide) == 0);
+  TEST_VERIFY_EXIT (iconv_close (from_wide) == 0);
+  return 0;
+}
+
+#include <support/test-driver.c>
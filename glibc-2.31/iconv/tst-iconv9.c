@@ -0,0 +1,88 @@
+/* Test repeated iconv_open and iconv_close of the same conversions.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <iconv.h>
+#include <string.h>
+#include <support/check.h>
+
+/* More pairs than the step arrays kept by gconv_cache.c, so that they
+   are evicted and set up again.  */
+static const char *const charsets[] =
+{
+  "ASCII", "UTF-8", "UCS-2", "UCS-4", "UCS-4LE", "UNICODEBIG",
+  "UNICODELITTLE"
+};
+#define NCHARSETS (sizeof (charsets) / sizeof (charsets[0]))
+
+#define INPUT "Hello, iconv!"
+
+static size_t
+convert (iconv_t cd, const char *in, size_t inlen, char *out,
+	 size_t outlen)
+{
+  char *inptr = (char *) in;
+  char *outptr = out;
+
+  TEST_COMPARE (iconv (cd, &inptr, &inlen, &outptr, &outlen), 0);
+  TEST_COMPARE (inlen, 0);
+  return outptr - out;
+}
+
+/* Convert INPUT from ASCII to FROM, then to TO and back to ASCII, with
+   two descriptors open for each conversion at the same time.  */
+static void
+check_pair (const char *from, const char *to)
+{
+  iconv_t cd1 = iconv_open (from, "ASCII");
+  iconv_t cd2 = iconv_open (to, from);
+  iconv_t cd2b = iconv_open (to, from);
+  iconv_t cd3 = iconv_open ("ASCII", to);
+  TEST_VERIFY_EXIT (cd1 != (iconv_t) -1);
+  TEST_VERIFY_EXIT (cd2 != (iconv_t) -1);
+  TEST_VERIFY_EXIT (cd2b != (iconv_t) -1);
+  TEST_VERIFY_EXIT (cd3 != (iconv_t) -1);
+
+  char buf1[256];
+  char buf2[256];
+  char buf2b[256];
+  char buf3[256];
+  size_t n1 = convert (cd1, INPUT, strlen (INPUT), buf1, sizeof (buf1));
+  size_t n2 = convert (cd2, buf1, n1, buf2, sizeof (buf2));
+  TEST_VERIFY_EXIT (iconv_close (cd2) == 0);
+  size_t n2b = convert (cd2b, buf1, n1, buf2b, sizeof (buf2b));
+  TEST_COMPARE_BLOB (buf2, n2, buf2b, n2b);
+  size_t n3 = convert (cd3, buf2b, n2b, buf3, sizeof (buf3));
+  TEST_COMPARE_BLOB (buf3, n3, INPUT, strlen (INPUT));
+
+  TEST_VERIFY_EXIT (iconv_close (cd1) == 0);
+  TEST_VERIFY_EXIT (iconv_close (cd2b) == 0);
+  TEST_VERIFY_EXIT (iconv_close (cd3) == 0);
+}
+
+static int
+do_test (void)
+{
+  for (int round = 0; round < 3; ++round)
+    for (size_t i = 0; i < NCHARSETS; ++i)
+      for (size_t j = 0; j < NCHARSETS; ++j)
+	check_pair (charsets[i], charsets[j]);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -4,6 +4,10 @@
 
 #ifndef _ISOMAC
 libc_hidden_proto (fnmatch)
+
+extern __typeof (fnmatch_compile) __fnmatch_compile attribute_hidden;
+extern __typeof (fnmatch_exec) __fnmatch_exec attribute_hidden;
+extern __typeof (fnmatch_free) __fnmatch_free attribute_hidden;
 #endif
 
 #endif
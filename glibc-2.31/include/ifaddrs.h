@@ -30,6 +30,10 @@ extern void __check_pf (bool *seen_ipv4, bool *seen_ipv6,
 			struct in6addrinfo **in6ai, size_t *in6ailen)
   attribute_hidden;
 extern void __free_in6ai (struct in6addrinfo *in6ai) attribute_hidden;
+/* Return a value which changes whenever the network interfaces, their
+   addresses or the routing tables change, or 0 if such changes cannot
+   be detected.  */
+extern uint32_t __check_pf_timestamp (void) attribute_hidden;
 extern void __check_native (uint32_t a1_index, int *a1_native,
 			    uint32_t a2_index, int *a2_native)
   attribute_hidden;
@@ -201,6 +201,10 @@ struct link_map
     unsigned int l_free_initfini:1; /* Nonzero if l_initfini can be
 				       freed, ie. not allocated with
 				       the dummy malloc in ld.so.  */
+    unsigned int l_ifunc_cacheable:1; /* Nonzero if the results of the
+					 IFUNC resolvers in this object
+					 may be cached, see
+					 dl-ifunc-cache.h.  */
 
     /* NODELETE status of the map.  Only valid for maps of type
        lt_loaded.  Lazy binding sets l_nodelete_active directly,
@@ -336,6 +340,12 @@ struct link_map
     size_t l_relro_size;
 
     unsigned long long int l_serial;
+
+    /* Time spent mapping, relocating and initializing this object.
+       Only recorded if the glibc.rtld.timing_report tunable is set.  */
+    uint64_t l_map_time;
+    uint64_t l_reloc_time;
+    uint64_t l_init_time;
   };
 
 /* Information used by audit modules.  For most link maps, this data
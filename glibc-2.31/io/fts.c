@@ -82,7 +82,7 @@ static char sccsid[] = "@(#)fts.c	8.6 (Berkeley) 8/14/94";
 # define FTSENTRY FTSENT
 # define INO_T ino_t
 # define STAT stat
-# define LSTAT lstat
+# define FSTATAT __fstatat
 #endif
 
 static FTSENTRY	*fts_alloc (FTSOBJ *, const char *, size_t);
@@ -93,7 +93,7 @@ static size_t	 fts_maxarglen (char * const *);
 static void	 fts_padjust (FTSOBJ *, FTSENTRY *);
 static int	 fts_palloc (FTSOBJ *, size_t);
 static FTSENTRY	*fts_sort (FTSOBJ *, FTSENTRY *, int);
-static u_short	 fts_stat (FTSOBJ *, FTSENTRY *, int);
+static u_short	 fts_stat (FTSOBJ *, FTSENTRY *, int, int);
 static int      fts_safe_changedir (FTSOBJ *, FTSENTRY *, int, const char *);
 
 #ifndef MAX
@@ -173,7 +173,7 @@ FTS_OPEN (char * const *argv, int options,
 		p->fts_level = FTS_ROOTLEVEL;
 		p->fts_parent = parent;
 		p->fts_accpath = p->fts_name;
-		p->fts_info = fts_stat(sp, p, ISSET(FTS_COMFOLLOW));
+		p->fts_info = fts_stat(sp, p, ISSET(FTS_COMFOLLOW), AT_FDCWD);
 
 		/* Command-line "." and ".." are real directories. */
 		if (p->fts_info == FTS_DOT)
@@ -327,7 +327,7 @@ FTS_READ (FTSOBJ *sp)
 
 	/* Any type of file may be re-visited; re-stat and re-turn. */
 	if (instr == FTS_AGAIN) {
-		p->fts_info = fts_stat(sp, p, 0);
+		p->fts_info = fts_stat(sp, p, 0, AT_FDCWD);
 		return (p);
 	}
 
@@ -339,7 +339,7 @@ FTS_READ (FTSOBJ *sp)
 	 */
 	if (instr == FTS_FOLLOW &&
 	    (p->fts_info == FTS_SL || p->fts_info == FTS_SLNONE)) {
-		p->fts_info = fts_stat(sp, p, 1);
+		p->fts_info = fts_stat(sp, p, 1, AT_FDCWD);
 		if (p->fts_info == FTS_D && !ISSET(FTS_NOCHDIR)) {
 			if ((p->fts_symfd = __open(".", O_RDONLY, 0)) < 0) {
 				p->fts_errno = errno;
@@ -431,7 +431,7 @@ next:	tmp = p;
 		if (p->fts_instr == FTS_SKIP)
 			goto next;
 		if (p->fts_instr == FTS_FOLLOW) {
-			p->fts_info = fts_stat(sp, p, 1);
+			p->fts_info = fts_stat(sp, p, 1, AT_FDCWD);
 			if (p->fts_info == FTS_D && !ISSET(FTS_NOCHDIR)) {
 				if ((p->fts_symfd =
 				    __open(".", O_RDONLY, 0)) < 0) {
@@ -580,11 +580,16 @@ FTS_CHILDREN(FTSOBJ *sp, int instr)
 	return (sp->fts_child);
 }
 
+/*
+ * Return true if the directory entry is known not to lead to a directory.
+ * In a logical walk symbolic links are followed, so they might.
+ */
 static inline int
-dirent_not_directory(const struct dirent *dp)
+dirent_not_directory(const struct dirent *dp, int logical)
 {
 #if defined DT_DIR && defined _DIRENT_HAVE_D_TYPE
-        return dp->d_type != DT_DIR && dp->d_type != DT_UNKNOWN;
+        return dp->d_type != DT_DIR && dp->d_type != DT_UNKNOWN
+               && !(logical && dp->d_type == DT_LNK);
 #else
         return 0;
 #endif
@@ -602,7 +607,8 @@ dirent_not_directory(const struct dirent *dp)
  * of subdirectories in a node is equal to the number of links to the parent.
  * The former skips all stat calls.  The latter skips stat calls in any leaf
  * directories and for any files after the subdirectories in the directory have
- * been found, cutting the stat calls by about 2/3.
+ * been found, cutting the stat calls by about 2/3.  The link count is only
+ * trusted in a physical walk; a logical walk still uses the file type.
  */
 static FTSENTRY *
 fts_build (FTSOBJ *sp, int type)
@@ -655,7 +661,7 @@ fts_build (FTSOBJ *sp, int type)
 		nostat = 1;
 	} else {
 		nlinks = -1;
-		nostat = 0;
+		nostat = ISSET(FTS_NOSTAT);
 	}
 
 #ifdef notdef
@@ -785,7 +791,8 @@ mem1:				saved_errno = errno;
 				p->fts_info = FTS_NSOK;
 			p->fts_accpath = cur->fts_accpath;
 		} else if (nlinks == 0
-                           || (nostat && dirent_not_directory(dp))) {
+                           || (nostat && dirent_not_directory(dp,
+							     ISSET(FTS_LOGICAL)))) {
 			p->fts_accpath =
 			    ISSET(FTS_NOCHDIR) ? p->fts_path : p->fts_name;
 			p->fts_info = FTS_NSOK;
@@ -796,8 +803,12 @@ mem1:				saved_errno = errno;
 				memmove(cp, p->fts_name, p->fts_namelen + 1);
 			} else
 				p->fts_accpath = p->fts_name;
-			/* Stat it. */
-			p->fts_info = fts_stat(sp, p, 0);
+			/*
+			 * Stat it relative to the open directory, which
+			 * saves looking up the whole path again with
+			 * FTS_NOCHDIR.
+			 */
+			p->fts_info = fts_stat(sp, p, 0, dirfd(dirp));
 
 			/* Decrement link count if applicable. */
 			if (nlinks > 0 && (p->fts_info == FTS_D ||
@@ -866,13 +877,18 @@ mem1:				saved_errno = errno;
 	return (head);
 }
 
+/*
+ * Stat P.  If DFD is not AT_FDCWD, the name of P is looked up relative to
+ * the directory DFD instead of using its access path.
+ */
 static u_short
-fts_stat (FTSOBJ *sp, FTSENTRY *p, int follow)
+fts_stat (FTSOBJ *sp, FTSENTRY *p, int follow, int dfd)
 {
 	FTSENTRY *t;
 	dev_t dev;
 	INO_T ino;
 	struct STAT *sbp, sb;
+	const char *path;
 	int saved_errno;
 
 	/* If user needs stat info, stat buffer already allocated. */
@@ -894,17 +910,18 @@ fts_stat (FTSOBJ *sp, FTSENTRY *p, int follow)
 	 * a stat(2).  If that fails, check for a non-existent symlink.  If
 	 * fail, set the errno from the stat call.
 	 */
+	path = dfd == AT_FDCWD ? p->fts_accpath : p->fts_name;
 	if (ISSET(FTS_LOGICAL) || follow) {
-		if (STAT(p->fts_accpath, sbp)) {
+		if (FSTATAT(dfd, path, sbp, 0)) {
 			saved_errno = errno;
-			if (!LSTAT(p->fts_accpath, sbp)) {
+			if (!FSTATAT(dfd, path, sbp, AT_SYMLINK_NOFOLLOW)) {
 				__set_errno (0);
 				return (FTS_SLNONE);
 			}
 			p->fts_errno = saved_errno;
 			goto err;
 		}
-	} else if (LSTAT(p->fts_accpath, sbp)) {
+	} else if (FSTATAT(dfd, path, sbp, AT_SYMLINK_NOFOLLOW)) {
 		p->fts_errno = errno;
 err:		memset(sbp, 0, sizeof(struct STAT));
 		return (FTS_NS);
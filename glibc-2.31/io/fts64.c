@@ -25,6 +25,6 @@
 #define FTSENTRY FTSENT64
 #define INO_T ino64_t
 #define STAT stat64
-#define LSTAT lstat64
+#define FSTATAT __fstatat64
 
 #include "fts.c"
@@ -0,0 +1,141 @@
+/* Test fts with FTS_LOGICAL and FTS_NOSTAT.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <fts.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/temp_file.h>
+#include <support/xunistd.h>
+
+/* The tree below the temporary directory, and what a logical walk
+   with FTS_NOSTAT reports for each entry.  Regular files are not
+   stat'ed, but symbolic links are, so that the walk can follow them
+   into directories.  */
+static struct
+{
+  const char *path;
+  int info;
+  int seen;
+} expected[] =
+  {
+    { "", FTS_D },
+    { "/dir", FTS_D },
+    { "/dir/file", FTS_NSOK },
+    { "/file", FTS_NSOK },
+    { "/dirlink", FTS_D },
+    { "/dirlink/file", FTS_NSOK },
+    { "/filelink", FTS_F },
+  };
+#define NEXPECTED (sizeof (expected) / sizeof (expected[0]))
+
+static void
+make_file (const char *path)
+{
+  xclose (xopen (path, O_WRONLY | O_CREAT | O_EXCL, 0600));
+  add_temp_file (path);
+}
+
+static void
+make_link (const char *target, const char *path)
+{
+  xsymlink (target, path);
+  add_temp_file (path);
+}
+
+static int
+do_test (void)
+{
+  char *root = support_create_temp_directory ("tst-fts-nostat-");
+  char *dir = xasprintf ("%s/dir", root);
+  xmkdir (dir, 0700);
+  add_temp_file (dir);
+  char *path = xasprintf ("%s/file", dir);
+  make_file (path);
+  free (path);
+  path = xasprintf ("%s/file", root);
+  make_file (path);
+  free (path);
+  path = xasprintf ("%s/dirlink", root);
+  make_link ("dir", path);
+  free (path);
+  path = xasprintf ("%s/filelink", root);
+  make_link ("file", path);
+  free (path);
+
+  /* The file types are only known without stat if the file system
+     fills in d_type.  */
+  DIR *stream = opendir (dir);
+  TEST_VERIFY_EXIT (stream != NULL);
+  struct dirent *e;
+  while ((e = readdir (stream)) != NULL)
+    if (strcmp (e->d_name, "file") == 0 && e->d_type != DT_REG)
+      FAIL_UNSUPPORTED ("file system does not report file types");
+  closedir (stream);
+  free (dir);
+
+  char *argv[] = { root, NULL };
+  FTS *fts = fts_open (argv, FTS_LOGICAL | FTS_NOSTAT, NULL);
+  TEST_VERIFY_EXIT (fts != NULL);
+  size_t rootlen = strlen (root);
+  FTSENT *ent;
+  while ((ent = fts_read (fts)) != NULL)
+    {
+      if (ent->fts_info == FTS_DP)
+	continue;
+      TEST_VERIFY_EXIT (strncmp (ent->fts_path, root, rootlen) == 0);
+      const char *relative = ent->fts_path + rootlen;
+      size_t i;
+      for (i = 0; i < NEXPECTED; ++i)
+	if (strcmp (relative, expected[i].path) == 0)
+	  break;
+      if (i == NEXPECTED)
+	{
+	  support_record_failure ();
+	  printf ("error: unexpected entry \"%s\"\n", ent->fts_path);
+	  continue;
+	}
+      if (ent->fts_info != expected[i].info)
+	{
+	  support_record_failure ();
+	  printf ("error: \"%s\": fts_info %d, expected %d\n",
+		  ent->fts_path, ent->fts_info, expected[i].info);
+	}
+      ++expected[i].seen;
+    }
+  TEST_COMPARE (errno, 0);
+  TEST_COMPARE (fts_close (fts), 0);
+
+  for (size_t i = 0; i < NEXPECTED; ++i)
+    if (expected[i].seen != 1)
+      {
+	support_record_failure ();
+	printf ("error: \"%s%s\" seen %d times\n",
+		root, expected[i].path, expected[i].seen);
+      }
+
+  free (root);
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -21,6 +21,7 @@
 #include <libc-lock.h>
 #include <errno.h>
 #include <locale.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -31,6 +32,73 @@
 __libc_rwlock_define (extern , __libc_setlocale_lock attribute_hidden)
 
 
+/* Locale objects for the same name are often created over and over
+   again, for example once per thread.  Remember the data found for the
+   last few names which were requested for all categories.  Only data
+   which cannot be unloaded (locales from the archive and data used by
+   setlocale) is remembered, so the pointers stay valid.  Protected by
+   __libc_setlocale_lock.  */
+#define NCACHED_LOCALES 8
+
+static struct cached_locale
+{
+  char *name;
+  struct __locale_data *locales[__LC_LAST];
+  const char *names[__LC_LAST];
+} cached_locales[NCACHED_LOCALES];
+static unsigned int cached_locales_next;
+
+
+/* Look up NAME in the cache and fill in RESULT and NEWNAMES.  */
+static bool
+find_cached_locale (const char *name, struct __locale_struct *result,
+		    const char *newnames[__LC_LAST])
+{
+  for (size_t idx = 0; idx < NCACHED_LOCALES; ++idx)
+    if (cached_locales[idx].name != NULL
+	&& strcmp (cached_locales[idx].name, name) == 0)
+      {
+	for (int cnt = 0; cnt < __LC_LAST; ++cnt)
+	  if (cnt != LC_ALL)
+	    {
+	      result->__locales[cnt] = cached_locales[idx].locales[cnt];
+	      newnames[cnt] = cached_locales[idx].names[cnt];
+	    }
+	return true;
+      }
+
+  return false;
+}
+
+
+/* Remember the data in RESULT and NEWNAMES for NAME, if it cannot go
+   away.  */
+static void
+add_cached_locale (const char *name, const struct __locale_struct *result,
+		   const char *newnames[__LC_LAST])
+{
+  for (int cnt = 0; cnt < __LC_LAST; ++cnt)
+    if (cnt != LC_ALL && result->__locales[cnt]->usage_count != UNDELETABLE)
+      return;
+
+  char *copy = __strdup (name);
+  if (copy == NULL)
+    return;
+
+  struct cached_locale *entry = &cached_locales[cached_locales_next];
+  cached_locales_next = (cached_locales_next + 1) % NCACHED_LOCALES;
+
+  free (entry->name);
+  entry->name = copy;
+  for (int cnt = 0; cnt < __LC_LAST; ++cnt)
+    if (cnt != LC_ALL)
+      {
+	entry->locales[cnt] = result->__locales[cnt];
+	entry->names[cnt] = newnames[cnt];
+      }
+}
+
+
 /* Use this when we come along an error.  */
 #define ERROR_RETURN							      \
   do {									      \
@@ -158,6 +226,48 @@ __newlocale (int category_mask, const char *locale, locale_t base)
 	ERROR_RETURN;
     }
 
+  /* New objects for all categories of a plain locale name can be set up
+     from the cache.  An empty name depends on the environment.  */
+  bool cacheable = (base == NULL && locale_path == NULL
+		    && category_mask == (1 << __LC_LAST) - 1 - (1 << LC_ALL)
+		    && locale[0] != '\0' && strchr (locale, ';') == NULL);
+  if (cacheable)
+    {
+      __libc_rwlock_rdlock (__libc_setlocale_lock);
+      bool found = find_cached_locale (locale, &result, newnames);
+      __libc_rwlock_unlock (__libc_setlocale_lock);
+
+      if (found)
+	{
+	  /* The data cannot be unloaded, so we need no lock to build
+	     the new object.  */
+	  names_len = 0;
+	  for (cnt = 0; cnt < __LC_LAST; ++cnt)
+	    if (cnt != LC_ALL && newnames[cnt] != _nl_C_name)
+	      names_len += strlen (newnames[cnt]) + 1;
+
+	  result_ptr = malloc (sizeof (struct __locale_struct) + names_len);
+	  if (result_ptr == NULL)
+	    return NULL;
+
+	  char *namep = (char *) (result_ptr + 1);
+	  for (cnt = 0; cnt < __LC_LAST; ++cnt)
+	    if (cnt != LC_ALL)
+	      {
+		if (newnames[cnt] == _nl_C_name)
+		  result.__names[cnt] = _nl_C_name;
+		else
+		  {
+		    result.__names[cnt] = namep;
+		    namep = __stpcpy (namep, newnames[cnt]) + 1;
+		  }
+	      }
+
+	  *result_ptr = result;
+	  goto update;
+	}
+    }
+
   /* Protect global data.  */
   __libc_rwlock_wrlock (__libc_setlocale_lock);
 
@@ -220,6 +330,9 @@ __newlocale (int category_mask, const char *locale, locale_t base)
 	  }
 
       *result_ptr = result;
+
+      if (cacheable)
+	add_cached_locale (locale, &result, newnames);
     }
   else
     {
@@ -277,3 +390,10 @@ __newlocale (int category_mask, const char *locale, locale_t base)
   return result_ptr;
 }
 weak_alias (__newlocale, newlocale)
+
+
+libc_freeres_fn (free_mem)
+{
+  for (size_t idx = 0; idx < NCACHED_LOCALES; ++idx)
+    free (cached_locales[idx].name);
+}
@@ -0,0 +1,71 @@
+/* Test repeated newlocale calls for the same locale name.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <ctype.h>
+#include <langinfo.h>
+#include <locale.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/check.h>
+
+static int
+do_test (void)
+{
+  /* Objects for all categories are only set up from the cache if
+     LOCPATH is not used.  */
+  TEST_COMPARE (unsetenv ("LOCPATH"), 0);
+
+  locale_t objs[20];
+  for (int i = 0; i < 20; ++i)
+    {
+      objs[i] = newlocale (LC_ALL_MASK, "POSIX", (locale_t) 0);
+      TEST_VERIFY_EXIT (objs[i] != (locale_t) 0);
+      for (int j = 0; j < i; ++j)
+	TEST_VERIFY (objs[i] != objs[j]);
+      TEST_COMPARE_STRING (nl_langinfo_l (_NL_LOCALE_NAME (LC_CTYPE),
+					  objs[i]), "C");
+      TEST_COMPARE_STRING (nl_langinfo_l (_NL_LOCALE_NAME (LC_TIME),
+					  objs[i]), "C");
+      TEST_COMPARE_STRING (nl_langinfo_l (CODESET, objs[i]),
+			   "ANSI_X3.4-1968");
+      TEST_VERIFY (isupper_l ('A', objs[i]));
+      TEST_COMPARE (toupper_l ('a', objs[i]), 'A');
+    }
+
+  /* Objects are independent of each other.  */
+  for (int i = 0; i < 20; i += 2)
+    freelocale (objs[i]);
+  for (int i = 1; i < 20; i += 2)
+    {
+      locale_t l = newlocale (LC_CTYPE_MASK, "C", objs[i]);
+      TEST_VERIFY_EXIT (l != (locale_t) 0);
+      TEST_COMPARE_STRING (nl_langinfo_l (_NL_LOCALE_NAME (LC_NUMERIC), l),
+			   "C");
+      freelocale (l);
+    }
+
+  /* A bogus name still fails.  */
+  TEST_VERIFY (newlocale (LC_ALL_MASK, "no_such_LOCALE", (locale_t) 0)
+	       == (locale_t) 0);
+  TEST_VERIFY (newlocale (LC_ALL_MASK, "no_such_LOCALE", (locale_t) 0)
+	       == (locale_t) 0);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -920,6 +920,7 @@ __reclaim_stacks (void)
 		      sizeof (curp->specific_1stblock));
 
 	      curp->specific_used = false;
+	      curp->specific_dirty = 0;
 
 	      for (size_t cnt = 1; cnt < PTHREAD_KEY_1STLEVEL_SIZE; ++cnt)
 		if (curp->specific[cnt] != NULL)
@@ -34,6 +34,13 @@ __pthread_enable_asynccancel (void)
   struct pthread *self = THREAD_SELF;
   int oldval = THREAD_GETMEM (self, cancelhandling);
 
+  /* If cancellation is disabled it cannot be acted upon during the
+     call, and only this thread can enable it again.  Skip the atomic
+     update and report the type as already asynchronous, so that
+     __pthread_disable_asynccancel has nothing to undo either.  */
+  if (oldval & CANCELSTATE_BITMASK)
+    return oldval | CANCELTYPE_BITMASK;
+
   while (1)
     {
       int newval = oldval | CANCELTYPE_BITMASK;
@@ -323,6 +323,11 @@ struct pthread
   /* Flag which is set when specific data is set.  */
   bool specific_used;
 
+  /* Bit N is set when a non-NULL value was stored in the second-level
+     block specific[N] since the last destructor round at thread exit.
+     Blocks without the bit set hold no data and are not scanned.  */
+  uint32_t specific_dirty;
+
   /* True if events must be reported.  */
   bool report_events;
 
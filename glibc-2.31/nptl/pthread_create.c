@@ -244,6 +244,10 @@ __find_in_stack_list (struct pthread *pd)
 }
 
 
+_Static_assert (PTHREAD_KEY_1STLEVEL_SIZE
+		<= sizeof (((struct pthread *) 0)->specific_dirty) * 8,
+		"specific_dirty has one bit per second-level block");
+
 /* Deallocate POSIX thread-local-storage.  */
 void
 attribute_hidden
@@ -261,52 +265,49 @@ __nptl_deallocate_tsd (void)
       round = 0;
       do
 	{
-	  size_t idx;
-
-	  /* So far no new nonzero data entry.  */
-	  THREAD_SETMEM (self, specific_used, false);
+	  /* Only the second-level blocks which received data since the
+	     last round can hold anything.  Destructors which store new
+	     values mark their blocks again for the next round.  */
+	  uint32_t dirty = THREAD_GETMEM (self, specific_dirty);
+	  THREAD_SETMEM (self, specific_dirty, 0);
 
-	  for (cnt = idx = 0; cnt < PTHREAD_KEY_1STLEVEL_SIZE; ++cnt)
+	  while (dirty != 0)
 	    {
-	      struct pthread_key_data *level2;
+	      cnt = __builtin_ctz (dirty);
+	      dirty &= dirty - 1;
 
-	      level2 = THREAD_GETMEM_NC (self, specific, cnt);
+	      struct pthread_key_data *level2
+		= THREAD_GETMEM_NC (self, specific, cnt);
+	      size_t idx = cnt * PTHREAD_KEY_2NDLEVEL_SIZE;
 
-	      if (level2 != NULL)
+	      for (size_t inner = 0; inner < PTHREAD_KEY_2NDLEVEL_SIZE;
+		   ++inner, ++idx)
 		{
-		  size_t inner;
+		  void *data = level2[inner].data;
 
-		  for (inner = 0; inner < PTHREAD_KEY_2NDLEVEL_SIZE;
-		       ++inner, ++idx)
+		  if (data != NULL)
 		    {
-		      void *data = level2[inner].data;
-
-		      if (data != NULL)
-			{
-			  /* Always clear the data.  */
-			  level2[inner].data = NULL;
-
-			  /* Make sure the data corresponds to a valid
-			     key.  This test fails if the key was
-			     deallocated and also if it was
-			     re-allocated.  It is the user's
-			     responsibility to free the memory in this
-			     case.  */
-			  if (level2[inner].seq
-			      == __pthread_keys[idx].seq
-			      /* It is not necessary to register a destructor
-				 function.  */
-			      && __pthread_keys[idx].destr != NULL)
-			    /* Call the user-provided destructor.  */
-			    __pthread_keys[idx].destr (data);
-			}
+		      /* Always clear the data.  */
+		      level2[inner].data = NULL;
+
+		      /* Make sure the data corresponds to a valid
+			 key.  This test fails if the key was
+			 deallocated and also if it was
+			 re-allocated.  It is the user's
+			 responsibility to free the memory in this
+			 case.  */
+		      if (level2[inner].seq
+			  == __pthread_keys[idx].seq
+			  /* It is not necessary to register a destructor
+			     function.  */
+			  && __pthread_keys[idx].destr != NULL)
+			/* Call the user-provided destructor.  */
+			__pthread_keys[idx].destr (data);
 		    }
 		}
-	      else
-		idx += PTHREAD_KEY_1STLEVEL_SIZE;
 	    }
 
-	  if (THREAD_GETMEM (self, specific_used) == 0)
+	  if (THREAD_GETMEM (self, specific_dirty) == 0)
 	    /* No data has been modified.  */
 	    goto just_free;
 	}
@@ -316,6 +317,7 @@ __nptl_deallocate_tsd (void)
       /* Just clear the memory of the first block for reuse.  */
       memset (&THREAD_SELF->specific_1stblock, '\0',
 	      sizeof (self->specific_1stblock));
+      THREAD_SETMEM (self, specific_dirty, 0);
 
     just_free:
       /* Free the memory for the other blocks.  */
@@ -45,7 +45,11 @@ __pthread_setspecific (pthread_key_t key, const void *value)
 
       /* Remember that we stored at least one set of data.  */
       if (value != NULL)
-	THREAD_SETMEM (self, specific_used, true);
+	{
+	  THREAD_SETMEM (self, specific_used, true);
+	  THREAD_SETMEM (self, specific_dirty,
+			 THREAD_GETMEM (self, specific_dirty) | 1);
+	}
     }
   else
     {
@@ -80,6 +84,9 @@ __pthread_setspecific (pthread_key_t key, const void *value)
 
       /* Remember that we stored at least one set of data.  */
       THREAD_SETMEM (self, specific_used, true);
+      if (value != NULL)
+	THREAD_SETMEM (self, specific_dirty,
+		       THREAD_GETMEM (self, specific_dirty) | (1U << idx1st));
     }
 
   /* Store the data and the sequence number so that we can recognize
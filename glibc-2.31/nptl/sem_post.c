@@ -79,6 +79,61 @@ __new_sem_post (sem_t *sem)
 versioned_symbol (libpthread, __new_sem_post, sem_post, GLIBC_2_1);
 
 
+/* Like sem_post, but add N tokens at once and wake up to N waiters with
+   a single futex call.  */
+int
+__sem_post_n (sem_t *sem, unsigned int n)
+{
+  struct new_sem *isem = (struct new_sem *) sem;
+  int private = isem->private;
+
+  if (n == 0)
+    return 0;
+
+#if __HAVE_64B_ATOMICS
+  /* See __new_sem_post for the MO.  */
+  uint64_t d = atomic_load_relaxed (&isem->data);
+  do
+    {
+      if (n > SEM_VALUE_MAX - (d & SEM_VALUE_MASK))
+	{
+	  __set_errno (EOVERFLOW);
+	  return -1;
+	}
+    }
+  while (!atomic_compare_exchange_weak_release (&isem->data, &d, d + n));
+
+  /* Wake as many of the potentially blocked waiters as can grab one of
+     the new tokens.  Waiters which register after our update see the
+     tokens without blocking.  */
+  uint64_t nwaiters = d >> SEM_NWAITERS_SHIFT;
+  if (nwaiters > 0)
+    futex_wake (((unsigned int *) &isem->data) + SEM_VALUE_OFFSET,
+		nwaiters < n ? (int) nwaiters : (int) n, private);
+#else
+  unsigned int v = atomic_load_relaxed (&isem->value);
+  do
+    {
+      if (n > SEM_VALUE_MAX - (v >> SEM_VALUE_SHIFT))
+	{
+	  __set_errno (EOVERFLOW);
+	  return -1;
+	}
+    }
+  while (!atomic_compare_exchange_weak_release
+	 (&isem->value, &v, v + (n << SEM_VALUE_SHIFT)));
+
+  /* We do not know how many waiters there are, see
+     __sem_wait_32_finish.  */
+  if ((v & SEM_NWAITERS_MASK) != 0)
+    futex_wake (&isem->value, (int) n, private);
+#endif
+
+  return 0;
+}
+weak_alias (__sem_post_n, sem_post_n)
+
+
 #if SHLIB_COMPAT (libpthread, GLIBC_2_0, GLIBC_2_1)
 int
 attribute_compat_text_section
@@ -159,6 +159,25 @@ __new_sem_wait_fast (struct new_sem *sem, int definitive_result)
 #endif
 }
 
+/* Spin for a while in the hope that a token is posted soon, which is
+   much cheaper than blocking and being woken up if the semaphore is
+   used as a work queue.  We use the same bound as adaptive mutexes.  */
+static int
+__new_sem_wait_spin (struct new_sem *sem)
+{
+  if (!__is_smp)
+    return -1;
+
+  int max_cnt = max_adaptive_count ();
+  for (int cnt = 0; cnt < max_cnt; ++cnt)
+    {
+      atomic_spin_nop ();
+      if (__new_sem_wait_fast (sem, 0) == 0)
+	return 0;
+    }
+  return -1;
+}
+
 /* Slow path that blocks.  */
 static int
 __attribute__ ((noinline))
@@ -167,6 +186,9 @@ __new_sem_wait_slow (struct new_sem *sem, clockid_t clockid,
 {
   int err = 0;
 
+  if (__new_sem_wait_spin (sem) == 0)
+    return 0;
+
 #if __HAVE_64B_ATOMICS
   /* Add a waiter.  Relaxed MO is sufficient because we can rely on the
      ordering provided by the RMW operations we use.  */
@@ -48,6 +48,7 @@ extern int __new_sem_init (sem_t *sem, int pshared, unsigned int value);
 extern int __old_sem_init (sem_t *sem, int pshared, unsigned int value);
 extern int __new_sem_destroy (sem_t *sem);
 extern int __new_sem_post (sem_t *sem);
+extern int __sem_post_n (sem_t *sem, unsigned int n);
 extern int __new_sem_wait (sem_t *sem);
 extern int __old_sem_wait (sem_t *sem);
 extern int __new_sem_trywait (sem_t *sem);
@@ -0,0 +1,87 @@
+/* Test sem_post_n.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <limits.h>
+#include <semaphore.h>
+#include <support/check.h>
+#include <support/xthread.h>
+
+#define NTHREADS 8
+
+static sem_t sem;
+static pthread_barrier_t barrier;
+
+static void *
+tf (void *arg)
+{
+  xpthread_barrier_wait (&barrier);
+  TEST_COMPARE (sem_wait (&sem), 0);
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  int val;
+
+  TEST_COMPARE (sem_init (&sem, 0, 0), 0);
+
+  /* Posting zero is a no-op.  */
+  TEST_COMPARE (sem_post_n (&sem, 0), 0);
+  TEST_COMPARE (sem_getvalue (&sem, &val), 0);
+  TEST_COMPARE (val, 0);
+
+  /* Without waiters, the value is simply incremented.  */
+  TEST_COMPARE (sem_post_n (&sem, 3), 0);
+  TEST_COMPARE (sem_getvalue (&sem, &val), 0);
+  TEST_COMPARE (val, 3);
+  for (int i = 0; i < 3; i++)
+    TEST_COMPARE (sem_trywait (&sem), 0);
+  TEST_COMPARE (sem_trywait (&sem), -1);
+  TEST_COMPARE (errno, EAGAIN);
+
+  /* A single call releases all blocked waiters.  */
+  xpthread_barrier_init (&barrier, NULL, NTHREADS + 1);
+  pthread_t th[NTHREADS];
+  for (int i = 0; i < NTHREADS; i++)
+    th[i] = xpthread_create (NULL, tf, NULL);
+  xpthread_barrier_wait (&barrier);
+  TEST_COMPARE (sem_post_n (&sem, NTHREADS), 0);
+  for (int i = 0; i < NTHREADS; i++)
+    xpthread_join (th[i]);
+  TEST_COMPARE (sem_getvalue (&sem, &val), 0);
+  TEST_COMPARE (val, 0);
+  xpthread_barrier_destroy (&barrier);
+  TEST_COMPARE (sem_destroy (&sem), 0);
+
+  /* Overflow leaves the semaphore unchanged.  */
+  TEST_COMPARE (sem_init (&sem, 0, SEM_VALUE_MAX - 1), 0);
+  TEST_COMPARE (sem_post_n (&sem, 2), -1);
+  TEST_COMPARE (errno, EOVERFLOW);
+  TEST_COMPARE (sem_getvalue (&sem, &val), 0);
+  TEST_COMPARE (val, SEM_VALUE_MAX - 1);
+  TEST_COMPARE (sem_post_n (&sem, 1), 0);
+  TEST_COMPARE (sem_getvalue (&sem, &val), 0);
+  TEST_COMPARE (val, SEM_VALUE_MAX);
+  TEST_COMPARE (sem_destroy (&sem), 0);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
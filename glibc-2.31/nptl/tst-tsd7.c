@@ -0,0 +1,78 @@
+/* Destructor rounds for thread-specific data in second-level blocks.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <support/check.h>
+#include <support/xthread.h>
+
+/* Enough keys to use several second-level blocks.  */
+#define NKEYS 200
+
+static pthread_key_t keys[NKEYS];
+static unsigned int calls[NKEYS];
+
+static void
+destr (void *arg)
+{
+  uintptr_t idx = (uintptr_t) arg - 1;
+  ++calls[idx];
+
+  /* The destructor of the first key stores a value for the last key,
+     which lives in another block, and the destructor of the last key
+     stores a value for the first key again.  The block of the first
+     key has already been scanned, so it needs another round.  */
+  if (idx == 0 && calls[idx] == 1)
+    TEST_COMPARE (pthread_setspecific (keys[NKEYS - 1],
+				       (void *) (uintptr_t) NKEYS), 0);
+  else if (idx == NKEYS - 1 && calls[idx] == 1)
+    TEST_COMPARE (pthread_setspecific (keys[0], (void *) 1), 0);
+}
+
+static void *
+tf (void *arg)
+{
+  /* Only use every third key, so some blocks stay sparse.  */
+  for (uintptr_t i = 0; i < NKEYS - 1; i += 3)
+    {
+      TEST_COMPARE (pthread_setspecific (keys[i], (void *) (i + 1)), 0);
+      TEST_VERIFY (pthread_getspecific (keys[i]) == (void *) (i + 1));
+    }
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  for (int i = 0; i < NKEYS; ++i)
+    TEST_COMPARE (pthread_key_create (&keys[i], destr), 0);
+
+  xpthread_join (xpthread_create (NULL, tf, NULL));
+
+  for (int i = 0; i < NKEYS; ++i)
+    if (i == 0)
+      TEST_COMPARE (calls[i], 2);
+    else if (i == NKEYS - 1)
+      TEST_COMPARE (calls[i], 1);
+    else
+      TEST_COMPARE (calls[i], i % 3 == 0 ? 1 : 0);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -443,6 +443,7 @@ prune_cache (struct database_dyn *table, time_t now, int fd)
   if (first <= last)
     {
       struct hashentry *head = NULL;
+      size_t nbatch = 0;
 
       /* Now we have to get the write lock since we are about to modify
 	 the table.  */
@@ -456,6 +457,20 @@ prune_cache (struct database_dyn *table, time_t now, int fd)
 	{
 	  if (mark[first])
 	    {
+	      /* Do not hold the lock for the whole table.  Each bucket
+		 is handled separately, and since we are the only thread
+		 removing entries the marks stay valid.  */
+	      if (++nbatch > CACHE_PRUNE_BATCH)
+		{
+		  pthread_rwlock_unlock (&table->lock);
+		  if (pthread_rwlock_trywrlock (&table->lock) != 0)
+		    {
+		      ++table->head->wrlockdelayed;
+		      pthread_rwlock_wrlock (&table->lock);
+		    }
+		  nbatch = 1;
+		}
+
 	      ref_t *old = &table->head->array[first];
 	      ref_t run = table->head->array[first];
 
@@ -530,8 +545,16 @@ prune_cache (struct database_dyn *table, time_t now, int fd)
   if (__glibc_unlikely (! mark_use_alloca))
     free (mark);
 
-  /* Run garbage collection if any entry has been removed or replaced.  */
+  /* Run garbage collection if any entry has been removed or replaced.
+     The collection stops all lookups and forces clients using the
+     mapped database to retry, so as long as there is plenty of free
+     space at the end of the data area the garbage is left for a later
+     run.  */
   if (any)
+    table->gc_pending = true;
+  if (table->gc_pending
+      && (now == LONG_MAX || table->last_alloc_failed
+	  || table->head->first_free > table->head->data_size / 2))
     gc (table);
 
   /* If there is no entry in the database and we therefore have no new
@@ -495,6 +495,8 @@ gc (struct database_dyn *db)
 
   /* We are done.  */
  out:
+  db->gc_pending = false;
+
   pthread_mutex_unlock (&db->memlock);
   pthread_rwlock_unlock (&db->lock);
 
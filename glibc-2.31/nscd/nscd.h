@@ -157,6 +157,7 @@ struct database_dyn
   pthread_mutex_t memlock;
   bool mmap_used;
   bool last_alloc_failed;
+  bool gc_pending;		/* Unreachable data awaits collection.  */
 };
 
 
@@ -189,6 +190,11 @@ struct database_dyn
    better information when it is really needed.  */
 #define CACHE_PRUNE_INTERVAL	15
 
+/* Number of hash buckets from which expired entries are removed while
+   holding the write lock, before lookups waiting for the lock get a
+   chance to run.  */
+#define CACHE_PRUNE_BATCH	64
+
 
 /* Global variables.  */
 extern struct database_dyn dbs[lastdb] attribute_hidden;
@@ -17,10 +17,16 @@
    <https://www.gnu.org/licenses/>.  */
 
 #include <stdio.h>
+#include <alloca.h>
 #include <ctype.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <libc-lock.h>
+#include <not-cancel.h>
 #include "nsswitch.h"
 
 #include <kernel-features.h>
@@ -33,6 +39,14 @@
 
    NEED_H_ERRNO - defined iff an arg `int *herrnop' is used.
 
+   NO_SNAPSHOT - defined iff lookups must not keep a copy of the file
+   in memory.
+
+   INDEX_NAME - defined iff lookups by name ('.') may use an index of
+   the first colon-separated field of each line.
+   INDEX_ID_FIELD - if defined, the number of the colon-separated field
+   which lookups by number ('=') may use an index of.
+
    Also see files-parse.c.
 */
 
@@ -126,6 +140,523 @@ CONCAT(_nss_files_end,ENTNAME) (void)
 
   return NSS_STATUS_SUCCESS;
 }
+
+#ifndef NO_SNAPSHOT
+
+/* The getXXbyYY lookups read the database file from a copy kept in
+   memory, so that repeated lookups do not have to open and read the
+   file again.  The copy is replaced when the file is replaced or
+   modified, which is checked with one stat call per lookup.  */
+struct file_snapshot
+{
+  /* Number of streams reading the snapshot, plus one while it is the
+     current one.  Protected by snapshot_lock.  */
+  unsigned int refcount;
+
+  /* The identity of the file the data was read from.  */
+  dev_t dev;
+  ino64_t ino;
+  off64_t size;
+  struct timespec mtime;
+  struct timespec ctime;
+
+  /* The index of the lines of DATA, or NULL.  */
+  struct file_index *index;
+
+  /* DATA is followed by a null byte.  */
+  size_t length;
+  char data[];
+};
+
+/* Protects the current snapshot and all reference counts.  */
+__libc_lock_define_initialized (static, snapshot_lock)
+
+static struct file_snapshot *snapshot;
+
+static bool
+snapshot_is_current (const struct file_snapshot *s, const struct stat64 *st)
+{
+  return (s->dev == st->st_dev && s->ino == st->st_ino
+	  && s->size == st->st_size
+	  && s->mtime.tv_sec == st->st_mtim.tv_sec
+	  && s->mtime.tv_nsec == st->st_mtim.tv_nsec
+	  && s->ctime.tv_sec == st->st_ctim.tv_sec
+	  && s->ctime.tv_nsec == st->st_ctim.tv_nsec);
+}
+
+#if defined INDEX_NAME || defined INDEX_ID_FIELD
+# define FILES_INDEX
+
+/* For large files, scanning every line for each lookup is expensive.
+   The index lists for every key hash the lines whose key has that
+   hash, in file order.  The keys are the ones nss_db uses: the name
+   itself, or the number printed in decimal.  Lookups only parse the
+   listed lines, so collisions and entries which the parser rejects
+   need no special treatment.  */
+enum
+{
+  INDEX_BY_NAME,		/* Lookups with DB_CHAR '.'.  */
+  INDEX_BY_ID,			/* Lookups with DB_CHAR '='.  */
+  INDEX_KINDS
+};
+
+# define INDEX_END UINT32_MAX
+
+struct file_index
+{
+  uint32_t mask;		/* Number of buckets minus one.  */
+  uint32_t nlines;
+  /* The start of each line in the snapshot.  */
+  uint32_t *offset;
+  /* For each kind: the first line in each bucket, and for each line
+     its key hash and the next line in the same bucket.  */
+  uint32_t *head[INDEX_KINDS];
+  uint32_t *hash[INDEX_KINDS];
+  uint32_t *next[INDEX_KINDS];
+};
+
+/* Return the index kind for lookups with DB_CHAR, or -1 if there is
+   no index for them.  */
+static int
+index_kind (char db_char)
+{
+# ifdef INDEX_NAME
+  if (db_char == '.')
+    return INDEX_BY_NAME;
+# endif
+# ifdef INDEX_ID_FIELD
+  if (db_char == '=')
+    return INDEX_BY_ID;
+# endif
+  return -1;
+}
+
+/* Compute the key hashes of the line at P.  Return false if the line
+   is empty or a comment.  */
+static bool
+index_line (const char *p, uint32_t hash[INDEX_KINDS])
+{
+  /* Skip leading blanks, as internal_getent does.  */
+  while (isspace (*p))
+    ++p;
+  if (*p == '\0' || *p == '#')
+    return false;
+
+  hash[INDEX_BY_NAME] = __nss_hash (p, strcspn (p, ":\n"));
+
+  hash[INDEX_BY_ID] = 0;
+# ifdef INDEX_ID_FIELD
+  for (int field = 0; field < INDEX_ID_FIELD && p != NULL; ++field)
+    {
+      p = strpbrk (p, ":\n");
+      if (p != NULL && *p == ':')
+	++p;
+      else
+	p = NULL;
+    }
+  if (p != NULL)
+    {
+      /* Convert the number as strtou32 in the parser does.  */
+      unsigned long int id = strtoul (p, NULL, 10);
+      if (sizeof (long int) > 4 && id > 0xffffffff)
+	id = 0xffffffff;
+
+      char key[sizeof (unsigned long int) * 3 + 1];
+      int len = __snprintf (key, sizeof (key), "%lu", id);
+      hash[INDEX_BY_ID] = __nss_hash (key, len);
+    }
+# endif
+
+  return true;
+}
+
+/* Build the index of the LENGTH bytes at DATA.  Return NULL on
+   failure, in which case lookups scan all lines.  */
+static struct file_index *
+index_build (const char *data, size_t length)
+{
+  /* This keeps the size computation below from overflowing.  */
+  if (length >= INDEX_END / 64)
+    return NULL;
+
+  uint32_t nlines = 0;
+  for (const char *p = data; p < data + length; ++nlines)
+    {
+      p = memchr (p, '\n', data + length - p);
+      if (p == NULL)
+	p = data + length;
+      else
+	++p;
+    }
+
+  uint32_t nbuckets = 16;
+  while (nbuckets < nlines)
+    nbuckets *= 2;
+
+  struct file_index *index
+    = malloc (sizeof (*index) + (nlines * (1 + 2 * INDEX_KINDS)
+				 + nbuckets * INDEX_KINDS)
+	      * sizeof (uint32_t));
+  if (index == NULL)
+    return NULL;
+  index->mask = nbuckets - 1;
+  index->nlines = nlines;
+  index->offset = (uint32_t *) (index + 1);
+  uint32_t *p = index->offset + nlines;
+  for (int kind = 0; kind < INDEX_KINDS; ++kind)
+    {
+      index->head[kind] = p;
+      index->hash[kind] = p + nbuckets;
+      index->next[kind] = p + nbuckets + nlines;
+      p += nbuckets + 2 * nlines;
+      memset (index->head[kind], 0xff, nbuckets * sizeof (uint32_t));
+    }
+
+  uint32_t line = 0;
+  for (const char *q = data; q < data + length; ++line)
+    {
+      index->offset[line] = q - data;
+      q = memchr (q, '\n', data + length - q);
+      if (q == NULL)
+	q = data + length;
+      else
+	++q;
+    }
+
+  /* Insert the lines in reverse order, so that the lists are in file
+     order.  */
+  while (line-- > 0)
+    {
+      uint32_t hash[INDEX_KINDS];
+
+      if (!index_line (data + index->offset[line], hash))
+	continue;
+      for (int kind = 0; kind < INDEX_KINDS; ++kind)
+	{
+	  uint32_t bucket = hash[kind] & index->mask;
+	  index->hash[kind][line] = hash[kind];
+	  index->next[kind][line] = index->head[kind][bucket];
+	  index->head[kind][bucket] = line;
+	}
+    }
+
+  return index;
+}
+#endif /* INDEX_NAME || INDEX_ID_FIELD */
+
+/* Read the whole database file into a new snapshot.  Return NULL if
+   the file cannot be read or is not a regular file.  */
+static struct file_snapshot *
+snapshot_read (void)
+{
+  int fd = __open_nocancel (DATAFILE, O_RDONLY | O_LARGEFILE | O_CLOEXEC);
+  if (fd < 0)
+    return NULL;
+
+  struct file_snapshot *s = NULL;
+  struct stat64 st;
+  if (fstat64 (fd, &st) == 0 && S_ISREG (st.st_mode)
+      && (uint64_t) st.st_size < SIZE_MAX - sizeof (*s))
+    s = malloc (sizeof (*s) + st.st_size + 1);
+  if (s != NULL)
+    {
+      s->refcount = 1;
+      s->index = NULL;
+      s->dev = st.st_dev;
+      s->ino = st.st_ino;
+      s->size = st.st_size;
+      s->mtime = st.st_mtim;
+      s->ctime = st.st_ctim;
+
+      /* If the file shrinks while it is read, keep what was read.  A
+	 later lookup sees the new size and reads the file again.  */
+      s->length = 0;
+      while (s->length < (size_t) st.st_size)
+	{
+	  ssize_t n = __read_nocancel (fd, s->data + s->length,
+				       st.st_size - s->length);
+	  if (n < 0 && errno == EINTR)
+	    continue;
+	  if (n < 0)
+	    {
+	      free (s);
+	      s = NULL;
+	      break;
+	    }
+	  if (n == 0)
+	    break;
+	  s->length += n;
+	}
+    }
+
+  __close_nocancel_nostatus (fd);
+
+  if (s != NULL)
+    {
+      s->data[s->length] = '\0';
+#ifdef FILES_INDEX
+      s->index = index_build (s->data, s->length);
+#endif
+    }
+  return s;
+}
+
+/* Drop a reference to S.  Must be called with snapshot_lock held.  */
+static void
+snapshot_release (struct file_snapshot *s)
+{
+  if (--s->refcount == 0)
+    {
+      free (s->index);
+      free (s);
+    }
+}
+
+/* Return a new reference to an up-to-date snapshot of the database
+   file, or NULL if there is none.  */
+static struct file_snapshot *
+snapshot_acquire (void)
+{
+  struct stat64 st;
+  struct file_snapshot *s;
+
+  __libc_lock_lock (snapshot_lock);
+
+  if (stat64 (DATAFILE, &st) != 0)
+    st.st_ino = 0;
+  if (snapshot != NULL && (st.st_ino == 0 || !snapshot_is_current (snapshot,
+								   &st)))
+    {
+      snapshot_release (snapshot);
+      snapshot = NULL;
+    }
+  if (snapshot == NULL && st.st_ino != 0)
+    snapshot = snapshot_read ();
+
+  s = snapshot;
+  if (s != NULL)
+    ++s->refcount;
+
+  __libc_lock_unlock (snapshot_lock);
+
+  return s;
+}
+
+/* A stdio stream reading from a snapshot, or from lines copied out
+   of one.  */
+struct snapshot_cookie
+{
+  /* The snapshot DATA points into, or NULL if DATA is BUFFER.  */
+  struct file_snapshot *snapshot;
+  const char *data;
+  size_t length;
+  size_t offset;
+  char buffer[];
+};
+
+static ssize_t
+snapshot_cookie_read (void *c, char *buf, size_t size)
+{
+  struct snapshot_cookie *cookie = c;
+  size_t left = cookie->length - cookie->offset;
+
+  if (size > left)
+    size = left;
+  memcpy (buf, cookie->data + cookie->offset, size);
+  cookie->offset += size;
+  return size;
+}
+
+static int
+snapshot_cookie_seek (void *c, off64_t *position, int whence)
+{
+  struct snapshot_cookie *cookie = c;
+  off64_t base;
+
+  switch (whence)
+    {
+    case SEEK_SET:
+      base = 0;
+      break;
+    case SEEK_CUR:
+      base = cookie->offset;
+      break;
+    case SEEK_END:
+      base = cookie->length;
+      break;
+    default:
+      __set_errno (EINVAL);
+      return -1;
+    }
+
+  if (*position < -base || *position > (off64_t) cookie->length - base)
+    {
+      __set_errno (EINVAL);
+      return -1;
+    }
+  cookie->offset = base + *position;
+  *position = cookie->offset;
+  return 0;
+}
+
+static int
+snapshot_cookie_close (void *c)
+{
+  struct snapshot_cookie *cookie = c;
+
+  if (cookie->snapshot != NULL)
+    {
+      __libc_lock_lock (snapshot_lock);
+      snapshot_release (cookie->snapshot);
+      __libc_lock_unlock (snapshot_lock);
+    }
+
+  free (cookie);
+  return 0;
+}
+
+static FILE *
+snapshot_fopen (struct snapshot_cookie *cookie)
+{
+  static const cookie_io_functions_t functions =
+    {
+      .read = snapshot_cookie_read,
+      .seek = snapshot_cookie_seek,
+      .close = snapshot_cookie_close
+    };
+
+  cookie->offset = 0;
+  return fopencookie (cookie, "r", functions);
+}
+
+/* Open a stream which reads all of S, taking over the reference to S.
+   If S is NULL or the stream cannot be created, read the file
+   directly.  Either way the stream is closed with internal_endent.  */
+static enum nss_status
+snapshot_setent (FILE **stream, struct file_snapshot *s)
+{
+  if (s != NULL)
+    {
+      struct snapshot_cookie *cookie = malloc (sizeof (*cookie));
+      if (cookie != NULL)
+	{
+	  cookie->snapshot = s;
+	  cookie->data = s->data;
+	  cookie->length = s->length;
+	  *stream = snapshot_fopen (cookie);
+	  if (*stream != NULL)
+	    return NSS_STATUS_SUCCESS;
+	  free (cookie);
+	}
+
+      __libc_lock_lock (snapshot_lock);
+      snapshot_release (s);
+      __libc_lock_unlock (snapshot_lock);
+    }
+
+  /* This also reports why the file could not be opened.  */
+  *stream = NULL;
+  return internal_setent (stream);
+}
+
+/* Open a stream for a getXXbyYY lookup.  */
+static enum nss_status
+internal_setent_lookup (FILE **stream)
+{
+  return snapshot_setent (stream, snapshot_acquire ());
+}
+
+#ifdef FILES_INDEX
+/* Return the length of line number LINE of S, with its newline.  */
+static size_t
+index_line_length (const struct file_snapshot *s, uint32_t line)
+{
+  size_t end = (line + 1 < s->index->nlines
+		? s->index->offset[line + 1] : s->length);
+  return end - s->index->offset[line];
+}
+
+/* Open a stream for a getXXbyYY lookup with DB_CHAR and KEY.  If the
+   snapshot is indexed, the stream only contains the lines which may
+   match KEY.  */
+static enum nss_status
+internal_setent_indexed (FILE **stream, char db_char, const char *key)
+{
+  struct file_snapshot *s = snapshot_acquire ();
+  int kind = index_kind (db_char);
+
+  if (s == NULL || s->index == NULL || kind < 0)
+    return snapshot_setent (stream, s);
+
+  const struct file_index *index = s->index;
+  uint32_t hash = __nss_hash (key, strlen (key));
+  uint32_t first = index->head[kind][hash & index->mask];
+  size_t length = 0;
+
+  /* Copy the candidate lines out of the snapshot.  Add a newline to
+     the last line of the file if it lacks one.  */
+  for (uint32_t line = first; line != INDEX_END;
+       line = index->next[kind][line])
+    if (index->hash[kind][line] == hash)
+      length += index_line_length (s, line) + 1;
+
+  struct snapshot_cookie *cookie = malloc (sizeof (*cookie) + length);
+  if (cookie == NULL)
+    return snapshot_setent (stream, s);
+
+  length = 0;
+  for (uint32_t line = first; line != INDEX_END;
+       line = index->next[kind][line])
+    if (index->hash[kind][line] == hash)
+      {
+	size_t len = index_line_length (s, line);
+	memcpy (cookie->buffer + length, s->data + index->offset[line], len);
+	length += len;
+	if (len == 0 || cookie->buffer[length - 1] != '\n')
+	  cookie->buffer[length++] = '\n';
+      }
+
+  __libc_lock_lock (snapshot_lock);
+  snapshot_release (s);
+  __libc_lock_unlock (snapshot_lock);
+
+  cookie->snapshot = NULL;
+  cookie->data = cookie->buffer;
+  cookie->length = length;
+  *stream = snapshot_fopen (cookie);
+  if (*stream != NULL)
+    return NSS_STATUS_SUCCESS;
+  free (cookie);
+  return internal_setent (stream);
+}
+
+# define KEYPRINTF(pattern, args...) __snprintf (key, size, pattern ,##args)
+# define IGNOREPATTERN(pattern, arg1, args...) (char *) (uintptr_t) arg1
+
+/* Open the stream for a DB_LOOKUP function.  */
+# define DB_LOOKUP_SETENT(stream, db_char, keysize, keypattern)		      \
+  ({									      \
+    char *key;								      \
+    if (db_char == '.')							      \
+      key = IGNOREPATTERN keypattern;					      \
+    else								      \
+      {									      \
+	const size_t size = (keysize) + 1;				      \
+	key = alloca (size);						      \
+	KEYPRINTF keypattern;						      \
+      }									      \
+    internal_setent_indexed (stream, db_char, key);			      \
+  })
+#endif /* FILES_INDEX */
+
+#else /* NO_SNAPSHOT */
+# define internal_setent_lookup internal_setent
+#endif
+
+#ifndef DB_LOOKUP_SETENT
+# define DB_LOOKUP_SETENT(stream, db_char, keysize, keypattern)		      \
+  internal_setent_lookup (stream)
+#endif
 
 
 /* Parsing the database file into `struct STRUCTURE' data structures.  */
@@ -263,7 +794,7 @@ _nss_files_get##name##_r (proto,					      \
   FILE *stream = NULL;							      \
 									      \
   /* Open file.  */							      \
-  status = internal_setent (&stream);					      \
+  status = DB_LOOKUP_SETENT (&stream, db_char, keysize, keypattern);	      \
 									      \
   if (status == NSS_STATUS_SUCCESS)					      \
     {									      \
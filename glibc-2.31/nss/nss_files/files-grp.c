@@ -27,6 +27,9 @@ struct grent_data {};
    to parse lines from the database file.  */
 #define EXTERN_PARSER
 #include "files-parse.c"
+/* Look up group names and group IDs through an index.  */
+#define INDEX_NAME
+#define INDEX_ID_FIELD 2
 #include GENERIC
 
 DB_LOOKUP (grnam, '.', 0, ("%s", name),
@@ -331,7 +331,7 @@ _nss_files_gethostbyname3_r (const char *name, int af, struct hostent *result,
   buflen = buflen > pad ? buflen - pad : 0;
 
   /* Open file.  */
-  enum nss_status status = internal_setent (&stream);
+  enum nss_status status = internal_setent_lookup (&stream);
 
   if (status == NSS_STATUS_SUCCESS)
     {
@@ -382,7 +382,7 @@ _nss_files_gethostbyname4_r (const char *name, struct gaih_addrtuple **pat,
   FILE *stream = NULL;
 
   /* Open file.  */
-  enum nss_status status = internal_setent (&stream);
+  enum nss_status status = internal_setent_lookup (&stream);
 
   if (status == NSS_STATUS_SUCCESS)
     {
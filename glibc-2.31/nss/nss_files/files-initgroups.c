@@ -17,21 +17,360 @@
    <https://www.gnu.org/licenses/>.  */
 
 #include <errno.h>
+#include <fcntl.h>
 #include <grp.h>
 #include <nss.h>
+#include <stdint.h>
 #include <stdio_ext.h>
 #include <string.h>
 #include <sys/param.h>
+#include <sys/stat.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <libc-lock.h>
+#include <not-cancel.h>
 #include <scratch_buffer.h>
 
-enum nss_status
-_nss_files_initgroups_dyn (const char *user, gid_t group, long int *start,
-			   long int *size, gid_t **groupsp, long int limit,
-			   int *errnop)
+#define DATAFILE "/etc/group"
+
+/* Append GID to the array *GROUPSP, which has room for *SIZE entries
+   of which *START are used, growing it up to LIMIT entries.  Return
+   false if GID could not be added; *STATUS is set to
+   NSS_STATUS_TRYAGAIN if memory ran out.  */
+static bool
+add_group (gid_t gid, long int *start, long int *size, gid_t **groupsp,
+	   long int limit, int *errnop, enum nss_status *status)
+{
+  gid_t *groups = *groupsp;
+
+  if (*start == *size)
+    {
+      /* Need a bigger buffer.  */
+      if (limit > 0 && *size == limit)
+	/* We reached the maximum.  */
+	return false;
+
+      long int newsize;
+      if (limit <= 0)
+	newsize = 2 * *size;
+      else
+	newsize = MIN (limit, 2 * *size);
+
+      gid_t *newgroups = realloc (groups, newsize * sizeof (*groups));
+      if (newgroups == NULL)
+	{
+	  *errnop = ENOMEM;
+	  *status = NSS_STATUS_TRYAGAIN;
+	  return false;
+	}
+      *groupsp = groups = newgroups;
+      *size = newsize;
+    }
+
+  groups[*start] = gid;
+  *start += 1;
+  return true;
+}
+
+/* initgroups needs the groups of one user, but the file lists the
+   members of each group.  Instead of parsing the whole file for each
+   call, the memberships are indexed by member name.  The index is
+   rebuilt when the file is replaced or modified, which is checked
+   with one stat call per lookup.  */
+struct membership
+{
+  uint32_t hash;
+  uint32_t next;		/* Next membership in the same bucket.  */
+  uint32_t line;		/* The line listing the membership.  */
+  uint32_t name;		/* Offset of the member name in NAMES.  */
+  gid_t gid;
+};
+
+#define INDEX_END UINT32_MAX
+
+struct member_index
+{
+  /* The identity of the file the index was built from.  */
+  dev_t dev;
+  ino64_t ino;
+  off64_t size;
+  struct timespec mtime;
+  struct timespec ctime;
+
+  uint32_t mask;		/* Number of buckets minus one.  */
+  uint32_t *head;		/* The first membership in each bucket.  */
+  struct membership *members;
+  char *names;
+};
+
+/* Protects current_index.  */
+__libc_lock_define_initialized (static, lock)
+
+static struct member_index *current_index;
+
+static bool
+index_is_current (const struct member_index *idx, const struct stat64 *st)
+{
+  return (idx->dev == st->st_dev && idx->ino == st->st_ino
+	  && idx->size == st->st_size
+	  && idx->mtime.tv_sec == st->st_mtim.tv_sec
+	  && idx->mtime.tv_nsec == st->st_mtim.tv_nsec
+	  && idx->ctime.tv_sec == st->st_ctim.tv_sec
+	  && idx->ctime.tv_nsec == st->st_ctim.tv_nsec);
+}
+
+static void
+index_free (struct member_index *idx)
+{
+  if (idx != NULL)
+    {
+      free (idx->head);
+      free (idx->members);
+      free (idx->names);
+      free (idx);
+    }
+}
+
+/* Read the whole file at FD, which has the status ST.  Return NULL on
+   failure.  The data is followed by a null byte; its length is stored
+   in *LENGTH.  */
+static char *
+read_file (int fd, const struct stat64 *st, size_t *length)
+{
+  if ((uint64_t) st->st_size >= SIZE_MAX)
+    return NULL;
+  char *data = malloc (st->st_size + 1);
+  if (data == NULL)
+    return NULL;
+
+  /* If the file shrinks while it is read, keep what was read.  A
+     later lookup sees the new size and builds the index again.  */
+  size_t len = 0;
+  while (len < (size_t) st->st_size)
+    {
+      ssize_t n = __read_nocancel (fd, data + len, st->st_size - len);
+      if (n < 0 && errno == EINTR)
+	continue;
+      if (n < 0)
+	{
+	  free (data);
+	  return NULL;
+	}
+      if (n == 0)
+	break;
+      len += n;
+    }
+  data[len] = '\0';
+  *length = len;
+  return data;
+}
+
+/* Add the members of GRP, parsed from line LINE, to the arrays of
+   IDX.  *NMEMBERS and *NAMESLEN are the used parts of the arrays,
+   *MAXMEMBERS and *MAXNAMES their sizes.  Return false on
+   allocation failure.  */
+static bool
+index_add_group (struct member_index *idx, const struct group *grp,
+		 uint32_t line, uint32_t *nmembers, uint32_t *maxmembers,
+		 uint32_t *nameslen, uint32_t *maxnames)
+{
+  for (char **m = grp->gr_mem; *m != NULL; ++m)
+    {
+      size_t len = strlen (*m);
+
+      if (*nmembers == *maxmembers)
+	{
+	  if (*maxmembers > SIZE_MAX / 2 / sizeof (*idx->members))
+	    return false;
+	  struct membership *newp
+	    = realloc (idx->members, 2 * *maxmembers * sizeof (*newp));
+	  if (newp == NULL)
+	    return false;
+	  idx->members = newp;
+	  *maxmembers *= 2;
+	}
+      while (*nameslen + len + 1 > *maxnames)
+	{
+	  char *newp = realloc (idx->names, 2 * *maxnames);
+	  if (newp == NULL)
+	    return false;
+	  idx->names = newp;
+	  *maxnames *= 2;
+	}
+
+      struct membership *e = &idx->members[(*nmembers)++];
+      e->hash = __nss_hash (*m, len);
+      e->line = line;
+      e->name = *nameslen;
+      e->gid = grp->gr_gid;
+      memcpy (idx->names + *nameslen, *m, len + 1);
+      *nameslen += len + 1;
+    }
+  return true;
+}
+
+/* Parse the file and build the index of its memberships.  Return NULL
+   if the file cannot be read or memory runs out, in which case the
+   caller scans the file instead.  */
+static struct member_index *
+index_build (void)
 {
-  FILE *stream = fopen ("/etc/group", "rce");
+  int fd = __open_nocancel (DATAFILE, O_RDONLY | O_LARGEFILE | O_CLOEXEC);
+  if (fd < 0)
+    return NULL;
+
+  struct stat64 st;
+  char *data = NULL;
+  size_t length;
+  if (fstat64 (fd, &st) == 0 && S_ISREG (st.st_mode))
+    data = read_file (fd, &st, &length);
+  __close_nocancel_nostatus (fd);
+  if (data == NULL)
+    return NULL;
+
+  /* This keeps the line numbers, the offsets of the names and the
+     sizes of the arrays below from overflowing.  */
+  if (length >= INDEX_END / 4)
+    {
+      free (data);
+      return NULL;
+    }
+
+  struct member_index *idx = calloc (1, sizeof (*idx));
+  if (idx == NULL)
+    {
+      free (data);
+      return NULL;
+    }
+  idx->dev = st.st_dev;
+  idx->ino = st.st_ino;
+  idx->size = st.st_size;
+  idx->mtime = st.st_mtim;
+  idx->ctime = st.st_ctim;
+
+  uint32_t nmembers = 0;
+  uint32_t maxmembers = 16;
+  uint32_t nameslen = 0;
+  uint32_t maxnames = 256;
+  idx->members = malloc (maxmembers * sizeof (*idx->members));
+  idx->names = malloc (maxnames);
+  bool ok = idx->members != NULL && idx->names != NULL;
+
+  /* Parse each line as the scan below does.  The parser modifies the
+     line, so it works on a copy.  */
+  struct scratch_buffer linebuf;
+  struct scratch_buffer tmpbuf;
+  scratch_buffer_init (&linebuf);
+  scratch_buffer_init (&tmpbuf);
+
+  uint32_t line = 0;
+  for (const char *p = data; ok && p < data + length; ++line)
+    {
+      const char *eol = memchr (p, '\n', data + length - p);
+      size_t len = eol != NULL ? eol - p : data + length - p;
+
+      while (true)
+	{
+	  if (!scratch_buffer_set_array_size (&linebuf, len + 1, 1))
+	    {
+	      ok = false;
+	      break;
+	    }
+	  memcpy (linebuf.data, p, len);
+	  ((char *) linebuf.data)[len] = '\0';
+
+	  struct group grp;
+	  int err;
+	  int res = _nss_files_parse_grent (linebuf.data, &grp, tmpbuf.data,
+					    tmpbuf.length, &err);
+	  if (res == -1)
+	    {
+	      if (!scratch_buffer_grow (&tmpbuf))
+		{
+		  ok = false;
+		  break;
+		}
+	      continue;
+	    }
+	  if (res > 0)
+	    ok = index_add_group (idx, &grp, line, &nmembers, &maxmembers,
+				  &nameslen, &maxnames);
+	  break;
+	}
+
+      p += len + 1;
+    }
+
+  scratch_buffer_free (&linebuf);
+  scratch_buffer_free (&tmpbuf);
+  free (data);
+
+  uint32_t nbuckets = 16;
+  while (nbuckets < nmembers)
+    nbuckets *= 2;
+  if (ok)
+    {
+      idx->head = malloc (nbuckets * sizeof (*idx->head));
+      ok = idx->head != NULL;
+    }
+  if (!ok)
+    {
+      index_free (idx);
+      return NULL;
+    }
+
+  /* Insert the memberships in reverse order, so that the lists are
+     in file order.  */
+  idx->mask = nbuckets - 1;
+  memset (idx->head, 0xff, nbuckets * sizeof (*idx->head));
+  for (uint32_t i = nmembers; i-- > 0; )
+    {
+      uint32_t bucket = idx->members[i].hash & idx->mask;
+      idx->members[i].next = idx->head[bucket];
+      idx->head[bucket] = i;
+    }
+
+  return idx;
+}
+
+/* Add the groups USER is a member of according to IDX, in file
+   order, except GROUP.  */
+static enum nss_status
+index_lookup (const struct member_index *idx, const char *user,
+	      gid_t group, long int *start, long int *size, gid_t **groupsp,
+	      long int limit, int *errnop)
+{
+  enum nss_status status = NSS_STATUS_SUCCESS;
+  bool any = false;
+  uint32_t hash = __nss_hash (user, strlen (user));
+  uint32_t last_line = INDEX_END;
+
+  for (uint32_t i = idx->head[hash & idx->mask]; i != INDEX_END;
+       i = idx->members[i].next)
+    {
+      const struct membership *e = &idx->members[i];
+
+      /* A user listed twice for a group is added once, as in the
+	 scan.  */
+      if (e->hash != hash || e->line == last_line || e->gid == group
+	  || strcmp (idx->names + e->name, user) != 0)
+	continue;
+      last_line = e->line;
+
+      if (!add_group (e->gid, start, size, groupsp, limit, errnop, &status))
+	break;
+      any = true;
+    }
+
+  return status == NSS_STATUS_SUCCESS && !any ? NSS_STATUS_NOTFOUND : status;
+}
+
+/* Find the groups of USER by parsing the whole file.  */
+static enum nss_status
+scan_file (const char *user, gid_t group, long int *start, long int *size,
+	   gid_t **groupsp, long int limit, int *errnop)
+{
+  FILE *stream = fopen (DATAFILE, "rce");
   if (stream == NULL)
     {
       *errnop = errno;
@@ -49,8 +388,6 @@ _nss_files_initgroups_dyn (const char *user, gid_t group, long int *start,
   struct scratch_buffer tmpbuf;
   scratch_buffer_init (&tmpbuf);
 
-  gid_t *groups = *groupsp;
-
   /* We have to iterate over the entire file.  */
   while (1)
     {
@@ -86,33 +423,9 @@ _nss_files_initgroups_dyn (const char *user, gid_t group, long int *start,
 	  if (strcmp (*m, user) == 0)
 	    {
 	      /* Matches user.  Insert this group.  */
-	      if (*start == *size)
-		{
-		  /* Need a bigger buffer.  */
-		  if (limit > 0 && *size == limit)
-		    /* We reached the maximum.  */
-		    goto out;
-
-		  long int newsize;
-		  if (limit <= 0)
-		    newsize = 2 * *size;
-		  else
-		    newsize = MIN (limit, 2 * *size);
-
-		  gid_t *newgroups = realloc (groups,
-					      newsize * sizeof (*groups));
-		  if (newgroups == NULL)
-		    {
-		      *errnop = ENOMEM;
-		      status = NSS_STATUS_TRYAGAIN;
-		      goto out;
-		    }
-		  *groupsp = groups = newgroups;
-		  *size = newsize;
-		}
-
-	      groups[*start] = grp.gr_gid;
-	      *start += 1;
+	      if (!add_group (grp.gr_gid, start, size, groupsp, limit,
+			      errnop, &status))
+		goto out;
 	      any = true;
 
 	      break;
@@ -128,3 +441,39 @@ _nss_files_initgroups_dyn (const char *user, gid_t group, long int *start,
 
   return status == NSS_STATUS_SUCCESS && !any ? NSS_STATUS_NOTFOUND : status;
 }
+
+enum nss_status
+_nss_files_initgroups_dyn (const char *user, gid_t group, long int *start,
+			   long int *size, gid_t **groupsp, long int limit,
+			   int *errnop)
+{
+  struct stat64 st;
+  enum nss_status status;
+
+  __libc_lock_lock (lock);
+
+  if (stat64 (DATAFILE, &st) != 0)
+    st.st_ino = 0;
+  if (current_index != NULL
+      && (st.st_ino == 0 || !index_is_current (current_index, &st)))
+    {
+      index_free (current_index);
+      current_index = NULL;
+    }
+  if (current_index == NULL && st.st_ino != 0)
+    current_index = index_build ();
+
+  if (current_index != NULL)
+    {
+      status = index_lookup (current_index, user, group, start, size,
+			     groupsp, limit, errnop);
+      __libc_lock_unlock (lock);
+      return status;
+    }
+
+  __libc_lock_unlock (lock);
+
+  /* Without an index, parse the file, which also reports errors
+     opening it.  */
+  return scan_file (user, group, start, size, groupsp, limit, errnop);
+}
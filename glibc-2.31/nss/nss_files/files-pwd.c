@@ -27,6 +27,9 @@ struct pwent_data {};
    to parse lines from the database file.  */
 #define EXTERN_PARSER
 #include "files-parse.c"
+/* Look up user names and user IDs through an index.  */
+#define INDEX_NAME
+#define INDEX_ID_FIELD 2
 #include GENERIC
 
 DB_LOOKUP (pwnam, '.', 0, ("%s", name),
@@ -27,6 +27,8 @@ struct sgent_data {};
    to parse lines from the database file.  */
 #define EXTERN_PARSER
 #include "files-parse.c"
+/* Do not keep password hashes in memory between lookups.  */
+#define NO_SNAPSHOT
 #include GENERIC
 
 DB_LOOKUP (sgnam, '.', 0, ("%s", name),
@@ -0,0 +1,130 @@
+/* Test nss_files lookups in large passwd and group files.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <grp.h>
+#include <pwd.h>
+#include <stdio.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/xstdio.h>
+
+enum { entry_count = 20000 };
+
+/* Write /etc/passwd and /etc/group with ENTRY_COUNT entries each, and
+   a few lines which the parser skips or treats specially.  */
+static void
+write_files (void)
+{
+  FILE *passwd = xfopen ("/etc/passwd", "w");
+  FILE *group = xfopen ("/etc/group", "w");
+
+  fputs ("# A comment\n\n  \n+:x:5000::::\n", passwd);
+  fputs ("# A comment\n\n-:x:5000:\n", group);
+  for (int i = 0; i < entry_count; ++i)
+    {
+      if (i % 1000 == 0)
+	{
+	  fprintf (passwd, "#user%d:x:%d:0::/:/bin/sh\n", i, i);
+	  fprintf (group, "#group%d:x:%d:\n", i, i);
+	}
+      /* Leading blanks and leading zeros are accepted by the parser.  */
+      fprintf (passwd, "%suser%d:x:%s%d:%d:gecos %d:/:/bin/sh\n",
+	       i % 7 == 0 ? "  " : "", i, i % 11 == 0 ? "0" : "",
+	       10000 + i, i, i);
+      fprintf (group, "%sgroup%d:x:%s%d:user%d\n",
+	       i % 7 == 0 ? "\t" : "", i, i % 11 == 0 ? "00" : "",
+	       10000 + i, i);
+    }
+  /* A duplicate entry, which must not be returned.  */
+  fputs ("user5:x:99:99:duplicate:/:/bin/sh\n", passwd);
+  /* The last line lacks its newline.  */
+  fputs ("last:x:4000:4000:last:/:/bin/sh", passwd);
+  fputs ("last:x:4000:", group);
+
+  xfclose (passwd);
+  xfclose (group);
+}
+
+static void
+check_user (int i)
+{
+  char name[32];
+  snprintf (name, sizeof (name), "user%d", i);
+
+  struct passwd *pw = getpwnam (name);
+  if (pw == NULL)
+    FAIL_EXIT1 ("getpwnam (\"%s\"): %m", name);
+  TEST_COMPARE (pw->pw_uid, 10000 + i);
+  TEST_COMPARE (pw->pw_gid, i);
+
+  pw = getpwuid (10000 + i);
+  if (pw == NULL)
+    FAIL_EXIT1 ("getpwuid (%d): %m", 10000 + i);
+  TEST_COMPARE_STRING (pw->pw_name, name);
+}
+
+static void
+check_group (int i)
+{
+  char name[32];
+  snprintf (name, sizeof (name), "group%d", i);
+
+  struct group *gr = getgrnam (name);
+  if (gr == NULL)
+    FAIL_EXIT1 ("getgrnam (\"%s\"): %m", name);
+  TEST_COMPARE (gr->gr_gid, 10000 + i);
+
+  gr = getgrgid (10000 + i);
+  if (gr == NULL)
+    FAIL_EXIT1 ("getgrgid (%d): %m", 10000 + i);
+  TEST_COMPARE_STRING (gr->gr_name, name);
+  TEST_VERIFY (gr->gr_mem[0] != NULL && gr->gr_mem[1] == NULL);
+}
+
+static int
+do_test (void)
+{
+  write_files ();
+
+  for (int i = 0; i < entry_count; i += 7)
+    {
+      check_user (i);
+      check_group (i);
+    }
+  check_user (entry_count - 1);
+  check_group (entry_count - 1);
+
+  TEST_COMPARE_STRING (getpwnam ("user5")->pw_gecos, "gecos 5");
+  TEST_COMPARE_STRING (getpwuid (4000)->pw_name, "last");
+  TEST_COMPARE_STRING (getgrgid (4000)->gr_name, "last");
+  TEST_COMPARE_STRING (getpwuid (99)->pw_name, "user5");
+
+  /* Comments, compat entries and missing entries are not found.  */
+  TEST_VERIFY (getpwnam ("#user0") == NULL);
+  TEST_VERIFY (getpwnam ("+") == NULL);
+  TEST_VERIFY (getpwuid (5000) == NULL);
+  TEST_VERIFY (getgrgid (5000) == NULL);
+  TEST_VERIFY (getpwnam ("user20000") == NULL);
+  TEST_VERIFY (getgrnam ("group20000") == NULL);
+  TEST_VERIFY (getpwuid (30000) == NULL);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,107 @@
+/* Test getgrouplist with nss_files.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <grp.h>
+#include <stdio.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/xstdio.h>
+
+enum { group_count = 5000, user_count = 500 };
+
+/* Write /etc/group.  Group I has the GID 10000 + I + OFFSET and the
+   members user(I % USER_COUNT) and user((I * 7) % USER_COUNT).  */
+static void
+write_group (int offset)
+{
+  FILE *fp = xfopen ("/etc/group.new", "w");
+  fputs ("# A comment\n\n#group:x:1:user1\n", fp);
+  for (int i = 0; i < group_count; ++i)
+    fprintf (fp, "group%d:x:%d:user%d,user%d\n", i, 10000 + i + offset,
+	     i % user_count, (i * 7) % user_count);
+  /* Duplicate members, and the primary group of user1.  */
+  fputs ("dup:x:20:user2,user2\n", fp);
+  fputs ("primary:x:1:user1\n", fp);
+  /* The last line lacks its newline.  */
+  fputs ("last:x:30:user3", fp);
+  xfclose (fp);
+  TEST_COMPARE (rename ("/etc/group.new", "/etc/group"), 0);
+}
+
+/* Check the groups of user U with the primary group GID, for the
+   file written by write_group (OFFSET).  */
+static void
+check_user (int u, gid_t gid, int offset)
+{
+  char name[32];
+  snprintf (name, sizeof (name), "user%d", u);
+
+  gid_t expected[group_count + 4];
+  int nexpected = 0;
+  expected[nexpected++] = gid;
+  for (int i = 0; i < group_count; ++i)
+    if (i % user_count == u || (i * 7) % user_count == u)
+      expected[nexpected++] = 10000 + i + offset;
+  if (u == 2)
+    expected[nexpected++] = 20;
+  if (u == 3)
+    expected[nexpected++] = 30;
+
+  gid_t groups[group_count + 4];
+  int ngroups = group_count + 4;
+  TEST_COMPARE (getgrouplist (name, gid, groups, &ngroups), ngroups);
+  TEST_COMPARE_BLOB (groups, ngroups * sizeof (gid_t),
+		     expected, nexpected * sizeof (gid_t));
+
+  /* A short array receives as many groups as fit.  */
+  if (nexpected > 2)
+    {
+      int nshort = 2;
+      TEST_COMPARE (getgrouplist (name, gid, groups, &nshort), -1);
+      TEST_COMPARE (nshort, nexpected);
+      TEST_COMPARE_BLOB (groups, 2 * sizeof (gid_t),
+			 expected, 2 * sizeof (gid_t));
+    }
+}
+
+static int
+do_test (void)
+{
+  write_group (0);
+  for (int u = 0; u < user_count; u += 13)
+    check_user (u, 1, 0);
+  check_user (1, 1, 0);
+  check_user (2, 1, 0);
+  check_user (3, 1, 0);
+  check_user (user_count - 1, 1, 0);
+
+  /* Non-members only get their primary group.  */
+  gid_t groups[4];
+  int ngroups = 4;
+  TEST_COMPARE (getgrouplist ("nobody", 7, groups, &ngroups), 1);
+  TEST_COMPARE (groups[0], 7);
+
+  /* The new file is used after it is replaced.  */
+  write_group (100000);
+  check_user (0, 1, 100000);
+  check_user (3, 1, 100000);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,90 @@
+/* Test that nss_files lookups notice changes to the database file.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pwd.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xunistd.h>
+
+/* Return the UID of NAME, or -1 if there is no such user.  */
+static int
+uid_of (const char *name)
+{
+  struct passwd *pw = getpwnam (name);
+  return pw == NULL ? -1 : (int) pw->pw_uid;
+}
+
+static int
+do_test (void)
+{
+  TEST_COMPARE (uid_of ("user1"), 1001);
+  TEST_COMPARE (uid_of ("user2"), 1002);
+  TEST_COMPARE (uid_of ("user3"), -1);
+  TEST_COMPARE (uid_of ("user1"), 1001);
+
+  /* A lookup which needs a larger buffer than the first try.  The
+     line has to be read again from the same stream.  */
+  {
+    struct passwd pwd;
+    struct passwd *result;
+    char buffer[64];
+    char small[8];
+    TEST_COMPARE (getpwnam_r ("user2", &pwd, small, sizeof (small), &result),
+		  ERANGE);
+    TEST_COMPARE (getpwnam_r ("user2", &pwd, buffer, sizeof (buffer),
+			      &result), 0);
+    TEST_VERIFY (result == &pwd);
+    TEST_COMPARE_STRING (pwd.pw_gecos, "second");
+  }
+
+  /* Replace the file, as editors and useradd do.  */
+  support_write_file_string ("/etc/passwd.new",
+			     "user1:x:2001:2001::/:/bin/sh\n"
+			     "user3:x:2003:2003::/:/bin/sh\n");
+  if (rename ("/etc/passwd.new", "/etc/passwd") != 0)
+    FAIL_EXIT1 ("rename: %m");
+  TEST_COMPARE (uid_of ("user1"), 2001);
+  TEST_COMPARE (uid_of ("user2"), -1);
+  TEST_COMPARE (uid_of ("user3"), 2003);
+
+  /* Rewrite the file in place with contents of the same size.  Set the
+     modification time explicitly so that the test does not depend on
+     the timestamp granularity.  */
+  support_write_file_string ("/etc/passwd",
+			     "user1:x:3001:3001::/:/bin/sh\n"
+			     "user4:x:3004:3004::/:/bin/sh\n");
+  const struct timespec times[2] = { { 1, 0 }, { 1, 0 } };
+  if (utimensat (AT_FDCWD, "/etc/passwd", times, 0) != 0)
+    FAIL_EXIT1 ("utimensat: %m");
+  TEST_COMPARE (uid_of ("user1"), 3001);
+  TEST_COMPARE (uid_of ("user3"), -1);
+  TEST_COMPARE (uid_of ("user4"), 3004);
+
+  /* Without the file there is nothing to find.  */
+  xunlink ("/etc/passwd");
+  TEST_COMPARE (uid_of ("user1"), -1);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -55,6 +55,23 @@ extern "C" {
    returning zero if it matches, FNM_NOMATCH if not.  */
 extern int fnmatch (const char *__pattern, const char *__name, int __flags);
 
+#ifdef _GNU_SOURCE
+/* A wildcard pattern compiled by `fnmatch_compile'.  */
+typedef struct __fnmatch_compiled fnmatch_t;
+
+/* Compile PATTERN for repeated matching with FLAGS, which are
+   interpreted as for `fnmatch'.  Return NULL if there is not enough
+   memory.  */
+extern fnmatch_t *fnmatch_compile (const char *__pattern, int __flags);
+
+/* Match NAME against the compiled pattern PATTERN, returning zero if it
+   matches, FNM_NOMATCH if not, and -1 on error.  */
+extern int fnmatch_exec (const fnmatch_t *__pattern, const char *__name);
+
+/* Free the compiled pattern PATTERN.  */
+extern void fnmatch_free (fnmatch_t *__pattern);
+#endif
+
 #ifdef	__cplusplus
 }
 #endif
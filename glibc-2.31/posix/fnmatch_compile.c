@@ -0,0 +1,476 @@
+/* Compiled wildcard patterns.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <fnmatch.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* A pattern is compiled into a sequence of elements.  Every element
+   other than ELEM_STAR and ELEM_SLASH matches exactly one byte.  Which
+   bytes an ELEM_FOLD or ELEM_SET element matches is decided once, at
+   compile time, by asking fnmatch about each byte.  This keeps the
+   locale-dependent parts (character classes, collation order of ranges,
+   case folding) consistent with fnmatch without duplicating them.
+
+   A star matches any string, so the segments between two stars can be
+   matched at their leftmost position without ever backtracking.  With
+   FNM_PATHNAME no element but ELEM_SLASH matches a slash, so the pattern
+   and the string are split at slashes and matched component by
+   component.  */
+enum
+{
+  ELEM_BYTE,			/* A literal byte.  */
+  ELEM_FOLD,			/* A literal matched with FNM_CASEFOLD.  */
+  ELEM_SET,			/* `?' or a bracket expression.  */
+  ELEM_STAR,			/* `*'.  */
+  ELEM_SLASH			/* `/' with FNM_PATHNAME.  */
+};
+
+enum
+{
+  MODE_COMPILED,
+  MODE_NEVER,			/* The pattern does not match any string.  */
+  MODE_FALLBACK			/* Call fnmatch with the saved pattern.  */
+};
+
+/* Character class names longer than this are left to fnmatch.  */
+#define CLASS_NAME_MAX 32
+
+struct fnmatch_elem
+{
+  unsigned char type;
+  unsigned char byte;		/* For ELEM_BYTE and ELEM_FOLD.  */
+  unsigned int set;		/* For ELEM_FOLD and ELEM_SET.  */
+};
+
+struct __fnmatch_compiled
+{
+  int flags;
+  int mode;
+  /* Nonzero if the pattern was compiled in a multibyte locale.  Only
+     ASCII is compiled then, and other strings go to fnmatch.  */
+  bool multibyte;
+  char *pattern;
+  size_t nelems;
+  struct fnmatch_elem *elems;
+  /* The byte of each ELEM_BYTE element, so that runs of literals can
+     be searched for with memmem.  */
+  char *bytes;
+  unsigned char (*sets)[32];
+};
+
+
+/* Return the closing `]' of the bracket expression which starts at P,
+   just after the `['.  Return NULL for the rare forms which are left to
+   fnmatch: unterminated brackets, collating symbols, equivalence
+   classes and a few ill-formed ranges and classes.  This follows the
+   parser in fnmatch_loop.c.  */
+static const unsigned char *
+bracket_end (const unsigned char *p, int flags, bool posixly_correct)
+{
+  unsigned char c;
+
+  if (*p == '!' || (!posixly_correct && *p == '^'))
+    ++p;
+
+  /* The first character is always part of the list, even `]'.  */
+  c = *p++;
+  while (1)
+    {
+      if (c == '\0')
+	return NULL;
+      if (c == '[' && (*p == '=' || *p == '.'))
+	return NULL;
+
+      if (c == '[' && *p == ':')
+	{
+	  const unsigned char *q = p + 1;
+
+	  while (*q >= 'a' && *q <= 'z')
+	    ++q;
+	  if (q[0] != ':' || q[1] != ']' || q - p > CLASS_NAME_MAX)
+	    return NULL;
+	  p = q + 2;
+	  c = *p++;
+	}
+      else
+	{
+	  if (c == '\\' && !(flags & FNM_NOESCAPE))
+	    {
+	      if (*p == '\0')
+		return NULL;
+	      ++p;
+	    }
+	  c = *p++;
+	  if (c == '-' && *p != ']')
+	    {
+	      /* The end of a range.  */
+	      c = *p++;
+	      if (c == '[')
+		return NULL;
+	      if (c == '\\' && !(flags & FNM_NOESCAPE))
+		c = *p++;
+	      if (c == '\0')
+		return NULL;
+	      c = *p++;
+	    }
+	}
+
+      if (c == ']')
+	return p - 1;
+    }
+}
+
+/* Fill SET with the bytes which PATTERN, a single element, matches.  */
+static void
+probe_set (const fnmatch_t *fm, unsigned char *set, const char *pattern)
+{
+  int limit = fm->multibyte ? 0x80 : UCHAR_MAX + 1;
+  char s[2] = { '\0', '\0' };
+
+  memset (set, '\0', sizeof (*fm->sets));
+  for (int b = 1; b < limit; ++b)
+    {
+      s[0] = b;
+      if (fnmatch (pattern, s, fm->flags & (FNM_NOESCAPE | FNM_CASEFOLD))
+	  == 0)
+	set[b / CHAR_BIT] |= 1 << (b % CHAR_BIT);
+    }
+}
+
+/* Translate PATTERN into the elements of FM.  Return the mode of the
+   compiled pattern.  FM->pattern is used as a scratch buffer.  */
+static int
+compile_pattern (fnmatch_t *fm, const char *pattern)
+{
+  const unsigned char *p = (const unsigned char *) pattern;
+  int flags = fm->flags;
+  bool posixly_correct = getenv ("POSIXLY_CORRECT") != NULL;
+  unsigned int any_set = UINT_MAX;
+  unsigned int fold_set[UCHAR_MAX + 1];
+  unsigned int nsets = 0;
+  size_t n = 0;
+
+  if ((flags & FNM_EXTMATCH) && strchr (pattern, '(') != NULL)
+    return MODE_FALLBACK;
+  if (fm->multibyte)
+    for (const unsigned char *q = p; *q != '\0'; ++q)
+      if (*q >= 0x80)
+	return MODE_FALLBACK;
+
+  memset (fold_set, 0xff, sizeof (fold_set));
+  while (*p != '\0')
+    {
+      struct fnmatch_elem *e = &fm->elems[n];
+      unsigned char c = *p++;
+
+      e->byte = '\0';
+      switch (c)
+	{
+	case '*':
+	  /* Consecutive stars are equivalent to a single one.  */
+	  if (n > 0 && e[-1].type == ELEM_STAR)
+	    continue;
+	  e->type = ELEM_STAR;
+	  break;
+
+	case '?':
+	  if (any_set == UINT_MAX)
+	    {
+	      any_set = nsets++;
+	      memset (fm->sets[any_set], 0xff, sizeof (*fm->sets));
+	    }
+	  e->type = ELEM_SET;
+	  e->set = any_set;
+	  break;
+
+	case '[':
+	  {
+	    const unsigned char *end = bracket_end (p, flags, posixly_correct);
+	    size_t len;
+
+	    if (end == NULL)
+	      return MODE_FALLBACK;
+	    len = end + 1 - (p - 1);
+	    memcpy (fm->pattern, p - 1, len);
+	    fm->pattern[len] = '\0';
+	    e->type = ELEM_SET;
+	    e->set = nsets++;
+	    probe_set (fm, fm->sets[e->set], fm->pattern);
+	    p = end + 1;
+	  }
+	  break;
+
+	case '/':
+	  if (flags & FNM_PATHNAME)
+	    {
+	      e->type = ELEM_SLASH;
+	      break;
+	    }
+	  goto literal;
+
+	case '\\':
+	  if (!(flags & FNM_NOESCAPE))
+	    {
+	      c = *p++;
+	      if (c == '\0')
+		/* Trailing \ loses.  */
+		return MODE_NEVER;
+	      if (c == '/' && (flags & FNM_PATHNAME))
+		/* fnmatch does not treat an escaped slash as a separator
+		   after a star.  */
+		return MODE_FALLBACK;
+	    }
+	  /* FALLTHROUGH */
+	default:
+	literal:
+	  e->byte = c;
+	  if (flags & FNM_CASEFOLD)
+	    {
+	      if (fold_set[c] == UINT_MAX)
+		{
+		  char lit[3] = { '\\', c, '\0' };
+
+		  fold_set[c] = nsets++;
+		  probe_set (fm, fm->sets[fold_set[c]],
+			     (flags & FNM_NOESCAPE) ? lit + 1 : lit);
+		}
+	      e->type = ELEM_FOLD;
+	      e->set = fold_set[c];
+	    }
+	  else
+	    e->type = ELEM_BYTE;
+	  break;
+	}
+
+      fm->bytes[n] = e->byte;
+      ++n;
+    }
+
+  fm->nelems = n;
+  return MODE_COMPILED;
+}
+
+fnmatch_t *
+__fnmatch_compile (const char *pattern, int flags)
+{
+  size_t len = strlen (pattern);
+  fnmatch_t *fm = calloc (1, sizeof (*fm));
+
+  if (fm == NULL)
+    return NULL;
+  fm->flags = flags;
+  fm->multibyte = MB_CUR_MAX > 1;
+
+  /* Every byte of the pattern produces at most one element and one
+     set.  */
+  fm->pattern = malloc (len + 1);
+  fm->elems = malloc ((len + 1) * sizeof (*fm->elems));
+  fm->bytes = malloc (len + 1);
+  fm->sets = malloc ((len + 1) * sizeof (*fm->sets));
+  if (fm->pattern == NULL || fm->elems == NULL || fm->bytes == NULL
+      || fm->sets == NULL)
+    {
+      __fnmatch_free (fm);
+      return NULL;
+    }
+
+  fm->mode = compile_pattern (fm, pattern);
+  memcpy (fm->pattern, pattern, len + 1);
+  return fm;
+}
+weak_alias (__fnmatch_compile, fnmatch_compile)
+
+static inline bool
+elem_matches (const fnmatch_t *fm, const struct fnmatch_elem *e,
+	      unsigned char c)
+{
+  if (e->type == ELEM_BYTE)
+    return c == e->byte;
+  return (fm->sets[e->set][c / CHAR_BIT] >> (c % CHAR_BIT)) & 1;
+}
+
+/* Match the N elements at E, none of them a star, against the N bytes
+   at S.  */
+static bool
+match_here (const fnmatch_t *fm, const struct fnmatch_elem *e, size_t n,
+	    const char *s)
+{
+  for (size_t i = 0; i < n; ++i)
+    if (!elem_matches (fm, &e[i], s[i]))
+      return false;
+  return true;
+}
+
+/* Return the leftmost position between P and PEND at which the N
+   elements at E match, or NULL.  */
+static const char *
+find_segment (const fnmatch_t *fm, const struct fnmatch_elem *e, size_t n,
+	      const char *p, const char *pend)
+{
+  const char *bytes = fm->bytes + (e - fm->elems);
+  size_t lit = 0;
+
+  while (lit < n && e[lit].type == ELEM_BYTE)
+    ++lit;
+
+  while ((size_t) (pend - p) >= n)
+    {
+      if (lit > 0)
+	{
+	  /* Skip to the next occurrence of the literal prefix.  */
+	  p = __memmem (p, pend - p - (n - lit), bytes, lit);
+	  if (p == NULL)
+	    return NULL;
+	}
+      if (match_here (fm, e + lit, n - lit, p + lit))
+	return p;
+      ++p;
+    }
+  return NULL;
+}
+
+/* Match the N elements at E, which contain no ELEM_SLASH, against the
+   SLEN bytes at S.  If PERIOD, a leading period has to be matched
+   explicitly.  */
+static bool
+match_component (const fnmatch_t *fm, const struct fnmatch_elem *e,
+		 size_t n, const char *s, size_t slen, bool period)
+{
+  size_t first, last, tail;
+  const char *p, *pend;
+
+  if (period && slen > 0 && s[0] == '.'
+      && (n == 0 || e[0].type == ELEM_STAR || e[0].type == ELEM_SET))
+    return false;
+
+  /* The elements before the first star are anchored at the start.  */
+  for (first = 0; first < n && e[first].type != ELEM_STAR; ++first)
+    ;
+  if (first == n)
+    return slen == n && match_here (fm, e, n, s);
+  if (first > slen || !match_here (fm, e, first, s))
+    return false;
+
+  /* The elements after the last star are anchored at the end.  */
+  for (last = n - 1; e[last].type != ELEM_STAR; --last)
+    ;
+  tail = n - last - 1;
+  if (first + tail > slen
+      || !match_here (fm, e + last + 1, tail, s + slen - tail))
+    return false;
+
+  /* Match each segment in between at its leftmost position.  The star
+     before it absorbs everything that is skipped, and the star after
+     it can absorb whatever a later position would have left.  */
+  p = s + first;
+  pend = s + slen - tail;
+  for (size_t i = first + 1; i < last; )
+    {
+      size_t j = i;
+
+      while (e[j].type != ELEM_STAR)
+	++j;
+      p = find_segment (fm, e + i, j - i, p, pend);
+      if (p == NULL)
+	return false;
+      p += j - i;
+      i = j + 1;
+    }
+  return true;
+}
+
+int
+__fnmatch_exec (const fnmatch_t *fm, const char *string)
+{
+  const struct fnmatch_elem *e = fm->elems;
+  const struct fnmatch_elem *end = e + fm->nelems;
+  int flags = fm->flags;
+  bool period = (flags & FNM_PERIOD) != 0;
+  size_t len;
+
+  if (fm->mode == MODE_NEVER)
+    return FNM_NOMATCH;
+  if (fm->mode == MODE_FALLBACK)
+    return fnmatch (fm->pattern, string, flags);
+
+  len = strlen (string);
+  if (fm->multibyte)
+    for (size_t i = 0; i < len; ++i)
+      if ((unsigned char) string[i] >= 0x80)
+	return fnmatch (fm->pattern, string, flags);
+
+  if (flags & FNM_PATHNAME)
+    {
+      const char *s = string;
+      const char *send = string + len;
+
+      while (1)
+	{
+	  const struct fnmatch_elem *cend = e;
+	  const char *slash;
+
+	  while (cend < end && cend->type != ELEM_SLASH)
+	    ++cend;
+	  slash = memchr (s, '/', send - s);
+	  if (cend == end)
+	    {
+	      /* The last component of the pattern.  */
+	      if (slash == NULL)
+		slash = send;
+	      else if (!(flags & FNM_LEADING_DIR))
+		return FNM_NOMATCH;
+	      return (match_component (fm, e, cend - e, s, slash - s, period)
+		      ? 0 : FNM_NOMATCH);
+	    }
+	  if (slash == NULL
+	      || !match_component (fm, e, cend - e, s, slash - s, period))
+	    return FNM_NOMATCH;
+	  e = cend + 1;
+	  s = slash + 1;
+	}
+    }
+
+  if (match_component (fm, e, fm->nelems, string, len, period))
+    return 0;
+  if (flags & FNM_LEADING_DIR)
+    /* "foo*" also matches "foobar/frobozz".  */
+    for (const char *slash = string;
+	 (slash = memchr (slash, '/', string + len - slash)) != NULL;
+	 ++slash)
+      if (match_component (fm, e, fm->nelems, string, slash - string,
+			   period))
+	return 0;
+  return FNM_NOMATCH;
+}
+weak_alias (__fnmatch_exec, fnmatch_exec)
+
+void
+__fnmatch_free (fnmatch_t *fm)
+{
+  if (fm == NULL)
+    return;
+  free (fm->pattern);
+  free (fm->elems);
+  free (fm->bytes);
+  free (fm->sets);
+  free (fm);
+}
+weak_alias (__fnmatch_free, fnmatch_free)
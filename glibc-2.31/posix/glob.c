@@ -1237,6 +1237,15 @@ prefix_array (const char *dirname, char **array, size_t n)
   return 0;
 }
 
+#ifdef _LIBC
+/* Compiling a pattern calls fnmatch for every byte value in each
+   bracket expression, a few microseconds per bracket expression.  The
+   compiled pattern saves between 10 and 300 nanoseconds per name over
+   fnmatch, so compiling only pays off in directories with about a
+   hundred entries or more.  */
+# define GLOB_COMPILE_THRESHOLD 128
+#endif
+
 /* Like 'glob', but PATTERN is a final pathname component,
    and matches are searched for in DIRECTORY.
    The GLOB_NOSORT bit in FLAGS is ignored.  No sorting is ever done.
@@ -1260,6 +1269,10 @@ glob_in_dir (const char *pattern, const char *directory, int flags,
   int meta;
   int save;
   int result;
+#ifdef _LIBC
+  fnmatch_t *compiled = NULL;
+  size_t nentries = 0;
+#endif
 
   alloca_used += sizeof init_names_buf;
 
@@ -1350,7 +1363,16 @@ glob_in_dir (const char *pattern, const char *directory, int flags,
 		  default: continue;
 		  }
 
+#ifdef _LIBC
+	      if (compiled == NULL && ++nentries == GLOB_COMPILE_THRESHOLD)
+		/* If this fails, continue with fnmatch.  */
+		compiled = __fnmatch_compile (pattern, fnm_flags);
+	      if ((compiled != NULL
+		   ? __fnmatch_exec (compiled, d.name)
+		   : fnmatch (pattern, d.name, fnm_flags)) == 0)
+#else
 	      if (fnmatch (pattern, d.name, fnm_flags) == 0)
+#endif
 		{
 		  if (cur == names->count)
 		    {
@@ -1476,6 +1498,9 @@ glob_in_dir (const char *pattern, const char *directory, int flags,
 	(*pglob->gl_closedir) (stream);
       else
 	closedir (stream);
+#ifdef _LIBC
+      __fnmatch_free (compiled);
+#endif
       __set_errno (save);
     }
 
@@ -23,6 +23,10 @@
 
 static reg_errcode_t re_compile_internal (regex_t *preg, const char * pattern,
 					  size_t length, reg_syntax_t syntax);
+static reg_errcode_t re_compile_set_internal (regex_t *preg,
+					      const char *const *patterns,
+					      size_t npatterns,
+					      reg_syntax_t syntax);
 static void re_compile_fastmap_iter (regex_t *bufp,
 				     const re_dfastate_t *init_state,
 				     char *fastmap);
@@ -35,6 +39,7 @@ static reg_errcode_t create_initial_state (re_dfa_t *dfa);
 #ifdef RE_ENABLE_I18N
 static void optimize_utf8 (re_dfa_t *dfa);
 #endif
+static void compute_literal_prefix (re_dfa_t *dfa);
 static reg_errcode_t analyze (regex_t *preg);
 static reg_errcode_t preorder (bin_tree_t *root,
 			       reg_errcode_t (fn (void *, bin_tree_t *)),
@@ -58,6 +63,8 @@ static reg_errcode_t calc_eclosure_iter (re_node_set *new_set, re_dfa_t *dfa,
 static reg_errcode_t calc_inveclosure (re_dfa_t *dfa);
 static Idx fetch_number (re_string_t *input, re_token_t *token,
 			 reg_syntax_t syntax);
+static void fetch_token (re_token_t *result, re_string_t *input,
+			 reg_syntax_t syntax);
 static int peek_token (re_token_t *token, re_string_t *input,
 			reg_syntax_t syntax);
 static bin_tree_t *parse (re_string_t *regexp, regex_t *preg,
@@ -636,6 +643,7 @@ regfree (regex_t *preg)
   if (__glibc_likely (dfa != NULL))
     {
       lock_fini (dfa->lock);
+      lock_fini (dfa->state_lock);
       free_dfa_content (dfa);
     }
   preg->buffer = NULL;
@@ -649,6 +657,85 @@ regfree (regex_t *preg)
 }
 libc_hidden_def (__regfree)
 weak_alias (__regfree, regfree)
+
+/* regset_comp compiles the NPATTERNS regular expressions in PATTERNS,
+   with CFLAGS as for regcomp, into SET.  Where possible they are
+   combined into one DFA, so that regset_exec finds the matches of all
+   of them in a single pass over the string.  Back-references and
+   multibyte matching cannot be handled that way; such sets are
+   compiled one pattern at a time instead.  */
+
+int
+regset_comp (regset_t *__restrict set, const char *const *__restrict patterns,
+	     size_t npatterns, int cflags)
+{
+  reg_errcode_t ret;
+  reg_syntax_t syntax = ((cflags & REG_EXTENDED) ? RE_SYNTAX_POSIX_EXTENDED
+			 : RE_SYNTAX_POSIX_BASIC);
+  size_t i;
+
+  memset (set, '\0', sizeof (regset_t));
+  set->__npatterns = npatterns;
+  if (npatterns == 0)
+    return REG_NOERROR;
+
+  syntax |= (cflags & REG_ICASE) ? RE_ICASE : 0;
+  if (cflags & REG_NEWLINE)
+    {
+      syntax &= ~RE_DOT_NEWLINE;
+      syntax |= RE_HAT_LISTS_NOT_NEWLINE;
+      set->__re.newline_anchor = 1;
+    }
+  set->__re.no_sub = 1;
+
+  ret = re_compile_set_internal (&set->__re, patterns, npatterns, syntax);
+  if (ret == REG_NOERROR)
+    {
+      const re_dfa_t *dfa = set->__re.buffer;
+      if (dfa->mb_cur_max == 1 && dfa->nbackref == 0)
+	return REG_NOERROR;
+      regfree (&set->__re);
+    }
+
+  /* Match the patterns one at a time.  This also reports errors which
+     are only detected when the patterns are compiled separately, such
+     as back-references to subexpressions of other patterns.  */
+  set->__patterns = re_malloc (regex_t, npatterns);
+  if (__glibc_unlikely (set->__patterns == NULL))
+    return REG_ESPACE;
+  for (i = 0; i < npatterns; ++i)
+    {
+      ret = regcomp (&set->__patterns[i], patterns[i], cflags | REG_NOSUB);
+      if (__glibc_unlikely (ret != REG_NOERROR))
+	{
+	  while (i-- > 0)
+	    regfree (&set->__patterns[i]);
+	  re_free (set->__patterns);
+	  set->__patterns = NULL;
+	  return ret;
+	}
+    }
+  return REG_NOERROR;
+}
+weak_alias (__regset_comp, regset_comp)
+
+/* Free dynamically allocated space used by SET.  */
+
+void
+regset_free (regset_t *set)
+{
+  size_t i;
+
+  regfree (&set->__re);
+  if (set->__patterns != NULL)
+    {
+      for (i = 0; i < set->__npatterns; ++i)
+	regfree (&set->__patterns[i]);
+      re_free (set->__patterns);
+      set->__patterns = NULL;
+    }
+}
+weak_alias (__regset_free, regset_free)
 
 /* Entry points compatible with 4.2 BSD regex library.  We don't define
    them unless specifically requested.  */
@@ -756,7 +843,9 @@ re_compile_internal (regex_t *preg, const char * pattern, size_t length,
   preg->used = sizeof (re_dfa_t);
 
   err = init_dfa (dfa, length);
-  if (__glibc_unlikely (err == REG_NOERROR && lock_init (dfa->lock) != 0))
+  if (__glibc_unlikely (err == REG_NOERROR
+			&& (lock_init (dfa->lock) != 0
+			    || lock_init (dfa->state_lock) != 0)))
     err = REG_ESPACE;
   if (__glibc_unlikely (err != REG_NOERROR))
     {
@@ -779,6 +868,7 @@ re_compile_internal (regex_t *preg, const char * pattern, size_t length,
       free_workarea_compile (preg);
       re_string_destruct (&regexp);
       lock_fini (dfa->lock);
+      lock_fini (dfa->state_lock);
       free_dfa_content (dfa);
       preg->buffer = NULL;
       preg->allocated = 0;
@@ -805,6 +895,9 @@ re_compile_internal (regex_t *preg, const char * pattern, size_t length,
   /* Then create the initial state of the dfa.  */
   err = create_initial_state (dfa);
 
+  if (err == REG_NOERROR && !(syntax & RE_ICASE) && preg->translate == NULL)
+    compute_literal_prefix (dfa);
+
   /* Release work areas.  */
   free_workarea_compile (preg);
   re_string_destruct (&regexp);
@@ -812,6 +905,7 @@ re_compile_internal (regex_t *preg, const char * pattern, size_t length,
   if (__glibc_unlikely (err != REG_NOERROR))
     {
       lock_fini (dfa->lock);
+      lock_fini (dfa->state_lock);
       free_dfa_content (dfa);
       preg->buffer = NULL;
       preg->allocated = 0;
@@ -820,6 +914,131 @@ re_compile_internal (regex_t *preg, const char * pattern, size_t length,
   return err;
 }
 
+/* Compile the NPATTERNS regular expressions in PATTERNS into one DFA.
+   Every pattern is terminated by its own END_OF_RE node, whose
+   opr.idx is the index of the pattern, and the patterns are joined as
+   alternatives behind a loop which accepts any byte, so that the DFA
+   can report the matches of all patterns anywhere in the input.  */
+
+static reg_errcode_t
+re_compile_set_internal (regex_t *preg, const char *const *patterns,
+			 size_t npatterns, reg_syntax_t syntax)
+{
+  reg_errcode_t err = REG_NOERROR;
+  re_dfa_t *dfa;
+  re_string_t regexp;
+  re_token_t token;
+  re_bitset_ptr_t anychar;
+  bin_tree_t *tree = NULL, *branch, *eor;
+  size_t length = 0;
+  size_t i;
+  int ch;
+
+  for (i = 0; i < npatterns; ++i)
+    length += strlen (patterns[i]);
+
+  preg->syntax = syntax;
+  preg->regs_allocated = REGS_UNALLOCATED;
+  dfa = re_malloc (re_dfa_t, 1);
+  if (__glibc_unlikely (dfa == NULL))
+    return REG_ESPACE;
+  preg->buffer = dfa;
+  preg->allocated = preg->used = sizeof (re_dfa_t);
+
+  err = init_dfa (dfa, length);
+  if (__glibc_unlikely (err == REG_NOERROR
+			&& (lock_init (dfa->lock) != 0
+			    || lock_init (dfa->state_lock) != 0)))
+    err = REG_ESPACE;
+  if (__glibc_unlikely (err != REG_NOERROR))
+    {
+      free_dfa_content (dfa);
+      preg->buffer = NULL;
+      preg->allocated = 0;
+      return err;
+    }
+  dfa->syntax = syntax;
+
+  for (i = 0; i < npatterns; ++i)
+    {
+      err = re_string_construct (&regexp, patterns[i], strlen (patterns[i]),
+				 preg->translate, (syntax & RE_ICASE) != 0,
+				 dfa);
+      if (__glibc_unlikely (err != REG_NOERROR))
+	{
+	  re_string_destruct (&regexp);
+	  goto free_return;
+	}
+      fetch_token (&token, &regexp, syntax | RE_CARET_ANCHORS_HERE);
+      branch = parse_reg_exp (&regexp, preg, &token, syntax, 0, &err);
+      re_string_destruct (&regexp);
+      if (__glibc_unlikely (err != REG_NOERROR && branch == NULL))
+	goto free_return;
+
+      eor = create_tree (dfa, NULL, NULL, END_OF_RE);
+      if (__glibc_unlikely (eor == NULL))
+	goto espace_return;
+      eor->token.opr.idx = i;
+      if (branch != NULL)
+	eor = create_tree (dfa, branch, eor, CONCAT);
+      tree = tree == NULL ? eor : create_tree (dfa, tree, eor, OP_ALT);
+      if (__glibc_unlikely (eor == NULL || tree == NULL))
+	goto espace_return;
+    }
+
+  /* The bracket accepts only ASCII characters until optimize_utf8 has
+     run, so that it does not prevent the optimization.  */
+  anychar = (re_bitset_ptr_t) calloc (sizeof (bitset_t), 1);
+  if (__glibc_unlikely (anychar == NULL))
+    goto espace_return;
+  for (ch = 0; ch < ASCII_CHARS; ++ch)
+    bitset_set (anychar, ch);
+  memset (&token, '\0', sizeof (token));
+  token.type = SIMPLE_BRACKET;
+  token.opr.sbcset = anychar;
+  branch = create_token_tree (dfa, NULL, NULL, &token);
+  if (__glibc_unlikely (branch == NULL))
+    {
+      re_free (anychar);
+      goto espace_return;
+    }
+  branch = create_tree (dfa, branch, NULL, OP_DUP_ASTERISK);
+  if (branch != NULL)
+    dfa->str_tree = create_tree (dfa, branch, tree, CONCAT);
+  if (__glibc_unlikely (dfa->str_tree == NULL))
+    goto espace_return;
+
+  err = analyze (preg);
+  if (__glibc_unlikely (err != REG_NOERROR))
+    goto free_return;
+
+#ifdef RE_ENABLE_I18N
+  if (dfa->is_utf8 && !(syntax & RE_ICASE) && preg->translate == NULL)
+    optimize_utf8 (dfa);
+#endif
+  if (dfa->mb_cur_max == 1)
+    bitset_set_all (anychar);
+
+  err = create_initial_state (dfa);
+  if (__glibc_likely (err == REG_NOERROR))
+    {
+      free_workarea_compile (preg);
+      return REG_NOERROR;
+    }
+  goto free_return;
+
+ espace_return:
+  err = REG_ESPACE;
+ free_return:
+  free_workarea_compile (preg);
+  lock_fini (dfa->lock);
+  lock_fini (dfa->state_lock);
+  free_dfa_content (dfa);
+  preg->buffer = NULL;
+  preg->allocated = 0;
+  return err;
+}
+
 /* Initialize DFA.  We use the length of the regular expression PAT_LEN
    as the initial length of some arrays.  */
 
@@ -1074,6 +1293,45 @@ create_initial_state (re_dfa_t *dfa)
   return REG_NOERROR;
 }
 
+/* Determine the bytes which every match must start with.  This is the
+   case as long as the only node in the epsilon closure of the current
+   node which consumes input is a plain character.  */
+
+static void
+compute_literal_prefix (re_dfa_t *dfa)
+{
+  const re_node_set *nodes = &dfa->init_state->nodes;
+
+  /* Back-references can transit without consuming input, and initial
+     states with constraints differ by context.  */
+  if (dfa->nbackref > 0 || dfa->init_state->has_constraint)
+    return;
+
+  while (dfa->literal_prefix_len < sizeof (dfa->literal_prefix))
+    {
+      Idx node = -1;
+      Idx i;
+
+      for (i = 0; i < nodes->nelem; ++i)
+	{
+	  const re_token_t *token = dfa->nodes + nodes->elems[i];
+	  if (IS_EPSILON_NODE (token->type))
+	    continue;
+	  if (node != -1 || token->type != CHARACTER || token->constraint)
+	    return;
+	  node = nodes->elems[i];
+	}
+      if (node == -1)
+	return;
+
+      dfa->literal_prefix[dfa->literal_prefix_len++]
+	= dfa->nodes[node].opr.c;
+      if (dfa->nexts[node] == -1)
+	return;
+      nodes = dfa->eclosures + dfa->nexts[node];
+    }
+}
+
 #ifdef RE_ENABLE_I18N
 /* If it is possible to do searching in single byte encoding instead of UTF-8
    to speed things up, set dfa->mb_cur_max to 1, clear is_utf8 and change
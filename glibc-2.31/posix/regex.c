@@ -55,6 +55,11 @@
 # define re_search_2(bufp, st1, s1, st2, s2, startpos, range, regs, stop) \
 	__re_search_2 (bufp, st1, s1, st2, s2, startpos, range, regs, stop)
 # define re_compile_fastmap(bufp) __re_compile_fastmap (bufp)
+# define regset_comp(set, patterns, npatterns, cflags) \
+	__regset_comp (set, patterns, npatterns, cflags)
+# define regset_exec(set, string, matched, eflags) \
+	__regset_exec (set, string, matched, eflags)
+# define regset_free(set) __regset_free (set)
 
 # include "../locale/localeinfo.h"
 #endif
@@ -650,6 +650,33 @@ extern size_t regerror (int __errcode, const regex_t *_Restrict_ __preg,
 
 extern void regfree (regex_t *__preg);
 
+#ifdef __USE_GNU
+/* A set of regular expressions compiled by 'regset_comp', so that
+   'regset_exec' can tell which of them match a string in one pass.  */
+typedef struct
+{
+  regex_t __re;
+  regex_t *__patterns;
+  size_t __npatterns;
+} regset_t;
+
+/* Compile the NPATTERNS regular expressions in PATTERNS into SET, using
+   CFLAGS as for 'regcomp'.  The storage must be freed with
+   'regset_free'.  */
+extern int regset_comp (regset_t *_Restrict_ __set,
+			const char *const *_Restrict_ __patterns,
+			size_t __npatterns, int __cflags);
+
+/* Set MATCHED[I] to 1 if the I-th pattern in SET matches STRING, and to
+   0 otherwise.  Return 0 if any pattern matches and REG_NOMATCH if none
+   does.  EFLAGS can contain REG_NOTBOL and REG_NOTEOL.  */
+extern int regset_exec (const regset_t *_Restrict_ __set,
+			const char *_Restrict_ __string,
+			char __matched[_Restrict_arr_], int __eflags);
+
+extern void regset_free (regset_t *__set);
+#endif
+
 
 #ifdef __cplusplus
 }
@@ -1493,17 +1493,24 @@ re_acquire_state (reg_errcode_t *err, const re_dfa_t *dfa,
   hash = calc_state_hash (nodes, 0);
   spot = dfa->state_table + (hash & dfa->state_hash_mask);
 
+  /* Other threads may be matching with the same DFA, so the state table
+     is only accessed with STATE_LOCK held.  */
+  lock_lock (((re_dfa_t *) dfa)->state_lock);
   for (i = 0 ; i < spot->num ; i++)
     {
       re_dfastate_t *state = spot->array[i];
       if (hash != state->hash)
 	continue;
       if (re_node_set_compare (&state->nodes, nodes))
-	return state;
+	{
+	  lock_unlock (((re_dfa_t *) dfa)->state_lock);
+	  return state;
+	}
     }
 
   /* There are no appropriate state in the dfa, create the new one.  */
   new_state = create_ci_newstate (dfa, nodes, hash);
+  lock_unlock (((re_dfa_t *) dfa)->state_lock);
   if (__glibc_unlikely (new_state == NULL))
     *err = REG_ESPACE;
 
@@ -1541,16 +1548,21 @@ re_acquire_state_context (reg_errcode_t *err, const re_dfa_t *dfa,
   hash = calc_state_hash (nodes, context);
   spot = dfa->state_table + (hash & dfa->state_hash_mask);
 
+  lock_lock (((re_dfa_t *) dfa)->state_lock);
   for (i = 0 ; i < spot->num ; i++)
     {
       re_dfastate_t *state = spot->array[i];
       if (state->hash == hash
 	  && state->context == context
 	  && re_node_set_compare (state->entrance_nodes, nodes))
-	return state;
+	{
+	  lock_unlock (((re_dfa_t *) dfa)->state_lock);
+	  return state;
+	}
     }
   /* There are no appropriate state in 'dfa', create the new one.  */
   new_state = create_cd_newstate (dfa, nodes, context, hash);
+  lock_unlock (((re_dfa_t *) dfa)->state_lock);
   if (__glibc_unlikely (new_state == NULL))
     *err = REG_ESPACE;
 
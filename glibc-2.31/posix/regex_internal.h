@@ -72,6 +72,18 @@
 # define lock_unlock(lock) ((void) 0)
 #endif
 
+#ifdef _LIBC
+# include <atomic.h>
+# define load_acquire(mem) atomic_load_acquire (mem)
+# define store_release(mem, val) atomic_store_release (mem, val)
+#elif defined __ATOMIC_ACQUIRE
+# define load_acquire(mem) __atomic_load_n (mem, __ATOMIC_ACQUIRE)
+# define store_release(mem, val) __atomic_store_n (mem, val, __ATOMIC_RELEASE)
+#else
+# define load_acquire(mem) (*(mem))
+# define store_release(mem, val) ((void) (*(mem) = (val)))
+#endif
+
 /* In case that the system doesn't have isblank().  */
 #if !defined _LIBC && ! (defined isblank || (HAVE_ISBLANK && HAVE_DECL_ISBLANK))
 # define isblank(ch) ((ch) == ' ' || (ch) == '\t')
@@ -136,6 +148,7 @@
 # define __mbrtowc mbrtowc
 # define __wcrtomb wcrtomb
 # define __regfree regfree
+# define __memmem memmem
 #endif /* not _LIBC */
 
 #ifndef SSIZE_MAX
@@ -694,10 +707,20 @@ struct re_dfa_t
   bitset_t word_char;
   reg_syntax_t syntax;
   Idx *subexp_map;
+  /* Bytes which every match starts with, so that the search can skip
+     to their next occurrence.  */
+  unsigned char literal_prefix[16];
+  unsigned char literal_prefix_len;
 #ifdef DEBUG
   char* re_str;
 #endif
+  /* Serializes the GNU re_search interfaces, which modify the
+     pattern buffer.  */
   lock_define (lock)
+  /* Protects STATE_TABLE and the publication of transition tables,
+     so that regexec can match concurrently with one DFA.  States and
+     transition tables are never changed once published.  */
+  lock_define (state_lock)
 };
 
 #define re_node_set_init_empty(set) memset (set, '\0', sizeof (re_node_set))
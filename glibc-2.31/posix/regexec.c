@@ -36,6 +36,10 @@ static reg_errcode_t re_search_internal (const regex_t *preg,
 					 Idx start, Idx last_start, Idx stop,
 					 size_t nmatch, regmatch_t pmatch[],
 					 int eflags);
+static reg_errcode_t re_search_set_internal (const regex_t *preg,
+					     const char *string, Idx length,
+					     char *matched, size_t npatterns,
+					     int eflags);
 static regoff_t re_search_2_stub (struct re_pattern_buffer *bufp,
 				  const char *string1, Idx length1,
 				  const char *string2, Idx length2,
@@ -194,7 +198,6 @@ regexec (const regex_t *__restrict preg, const char *__restrict string,
 {
   reg_errcode_t err;
   Idx start, length;
-  re_dfa_t *dfa = preg->buffer;
 
   if (eflags & ~(REG_NOTBOL | REG_NOTEOL | REG_STARTEND))
     return REG_BADPAT;
@@ -210,14 +213,14 @@ regexec (const regex_t *__restrict preg, const char *__restrict string,
       length = strlen (string);
     }
 
-  lock_lock (dfa->lock);
+  /* regexec does not modify PREG, and the DFA can be shared by
+     concurrent matchers, so no lock is needed here.  */
   if (preg->no_sub)
     err = re_search_internal (preg, string, length, start, length,
 			      length, 0, NULL, eflags);
   else
     err = re_search_internal (preg, string, length, start, length,
 			      length, nmatch, pmatch, eflags);
-  lock_unlock (dfa->lock);
   return err != REG_NOERROR;
 }
 
@@ -243,6 +246,36 @@ compat_symbol (libc, __compat_regexec, regexec, GLIBC_2_0);
 # endif
 #endif
 
+/* regset_exec sets MATCHED[I] to 1 if the I-th pattern of SET matches
+   STRING and to 0 otherwise.  Return 0 if any of the patterns matches,
+   REG_NOMATCH if none does, and REG_ESPACE if memory ran out.  */
+
+int
+regset_exec (const regset_t *__restrict set, const char *__restrict string,
+	     char matched[], int eflags)
+{
+  size_t i;
+  int ret;
+
+  if (eflags & ~(REG_NOTBOL | REG_NOTEOL))
+    return REG_BADPAT;
+
+  if (set->__re.buffer != NULL)
+    return re_search_set_internal (&set->__re, string, strlen (string),
+				   matched, set->__npatterns, eflags);
+
+  ret = REG_NOMATCH;
+  for (i = 0; i < set->__npatterns; ++i)
+    {
+      matched[i] = (regexec (&set->__patterns[i], string, 0, NULL, eflags)
+		    == 0);
+      if (matched[i])
+	ret = REG_NOERROR;
+    }
+  return ret;
+}
+weak_alias (__regset_exec, regset_exec)
+
 /* Entry points for GNU code.  */
 
 /* re_match, re_search, re_match_2, re_search_2
@@ -708,7 +741,24 @@ re_search_internal (const regex_t *preg, const char *string, Idx length,
 	  goto forward_match_found_start_or_reached_end;
 
 	case 6:
-	  /* Fastmap without translation, match forward.  */
+	  /* Fastmap without translation, match forward.  If every match
+	     starts with the same bytes, search for them directly.  */
+	  if (dfa->literal_prefix_len > 0)
+	    {
+	      Idx len = dfa->literal_prefix_len;
+	      Idx end = MIN (right_lim + len, stop);
+	      const char *p = NULL;
+	      if (match_first + len <= end)
+		p = (len == 1
+		     ? memchr (string + match_first, dfa->literal_prefix[0],
+			       end - match_first)
+		     : __memmem (string + match_first, end - match_first,
+				 dfa->literal_prefix, len));
+	      if (p == NULL)
+		goto free_return;
+	      match_first = p - string;
+	      break;
+	    }
 	  while (__glibc_likely (match_first < right_lim)
 		 && !fastmap[(unsigned char) string[match_first]])
 	    ++match_first;
@@ -1203,6 +1253,126 @@ check_halt_state_context (const re_match_context_t *mctx,
   return 0;
 }
 
+/* Match the DFA compiled by re_compile_set_internal in PREG against
+   STRING, whose length is LENGTH, in a single pass, and record in
+   MATCHED which of its NPATTERNS patterns match.  The DFA restarts
+   every pattern at each position, so a halt state is reached whenever
+   a match of some pattern ends, and its END_OF_RE nodes tell which
+   patterns those are.  */
+
+static reg_errcode_t
+__attribute_warn_unused_result__
+re_search_set_internal (const regex_t *preg, const char *string, Idx length,
+			char *matched, size_t npatterns, int eflags)
+{
+  reg_errcode_t err;
+  const re_dfa_t *dfa = preg->buffer;
+  re_match_context_t mctx = { .dfa = dfa };
+  re_dfastate_t *cur_state;
+  size_t nmatched = 0;
+  Idx i;
+
+  memset (matched, '\0', npatterns);
+
+  err = re_string_allocate (&mctx.input, string, length, dfa->nodes_len + 1,
+			    preg->translate, (preg->syntax & RE_ICASE) != 0,
+			    dfa);
+  if (__glibc_unlikely (err != REG_NOERROR))
+    goto free_return;
+  mctx.input.stop = length;
+  mctx.input.raw_stop = length;
+  mctx.input.newline_anchor = preg->newline_anchor;
+  mctx.input.tip_context = (eflags & REG_NOTBOL) ? CONTEXT_BEGBUF
+			   : CONTEXT_NEWLINE | CONTEXT_BEGBUF;
+
+  err = match_ctx_init (&mctx, eflags, 0);
+  if (__glibc_unlikely (err != REG_NOERROR))
+    goto free_return;
+
+  /* The transitions of multibyte nodes are recorded in the state log,
+     as in re_search_internal.  */
+  if (dfa->has_mb_node)
+    {
+      /* Avoid overflow.  */
+      if (__glibc_unlikely ((MIN (IDX_MAX, SIZE_MAX / sizeof (re_dfastate_t *))
+			     <= mctx.input.bufs_len)))
+	{
+	  err = REG_ESPACE;
+	  goto free_return;
+	}
+
+      mctx.state_log = re_malloc (re_dfastate_t *, mctx.input.bufs_len + 1);
+      if (__glibc_unlikely (mctx.state_log == NULL))
+	{
+	  err = REG_ESPACE;
+	  goto free_return;
+	}
+    }
+
+  err = re_string_reconstruct (&mctx.input, 0, eflags);
+  if (__glibc_unlikely (err != REG_NOERROR))
+    goto free_return;
+
+  cur_state = acquire_init_state_context (&err, &mctx, 0);
+  if (__glibc_unlikely (cur_state == NULL))
+    {
+      DEBUG_ASSERT (err == REG_ESPACE);
+      goto free_return;
+    }
+  if (mctx.state_log != NULL)
+    mctx.state_log[0] = cur_state;
+
+  for (;;)
+    {
+      if (cur_state->halt)
+	{
+	  Idx cur_idx = re_string_cur_idx (&mctx.input);
+	  unsigned int context = re_string_context_at (&mctx.input, cur_idx,
+						       eflags);
+	  for (i = 0; i < cur_state->nodes.nelem; ++i)
+	    {
+	      Idx node = cur_state->nodes.elems[i];
+	      if (check_halt_node_context (dfa, node, context)
+		  && !matched[dfa->nodes[node].opr.idx])
+		{
+		  matched[dfa->nodes[node].opr.idx] = 1;
+		  ++nmatched;
+		}
+	    }
+	}
+      if (nmatched == npatterns || re_string_eoi (&mctx.input))
+	break;
+
+      Idx next_char_idx = re_string_cur_idx (&mctx.input) + 1;
+      if ((__glibc_unlikely (next_char_idx >= mctx.input.bufs_len)
+	   && mctx.input.bufs_len < mctx.input.len)
+	  || (__glibc_unlikely (next_char_idx >= mctx.input.valid_len)
+	      && mctx.input.valid_len < mctx.input.len))
+	{
+	  err = extend_buffers (&mctx, next_char_idx + 1);
+	  if (__glibc_unlikely (err != REG_NOERROR))
+	    goto free_return;
+	}
+
+      cur_state = transit_state (&err, &mctx, cur_state);
+      if (mctx.state_log != NULL)
+	cur_state = merge_state_with_log (&err, &mctx, cur_state);
+      if (cur_state == NULL)
+	{
+	  if (__glibc_unlikely (err != REG_NOERROR))
+	    goto free_return;
+	  break;
+	}
+    }
+
+  err = nmatched > 0 ? REG_NOERROR : REG_NOMATCH;
+
+ free_return:
+  re_free (mctx.state_log);
+  re_string_destruct (&mctx.input);
+  return err;
+}
+
 /* Compute the next node to which "NFA" transit from NODE("NFA" is a NFA
    corresponding to the DFA).
    Return the destination node, and update EPS_VIA_NODES;
@@ -2231,11 +2401,11 @@ transit_state (reg_errcode_t *err, re_match_context_t *mctx,
   ch = re_string_fetch_byte (&mctx->input);
   for (;;)
     {
-      trtable = state->trtable;
+      trtable = load_acquire (&state->trtable);
       if (__glibc_likely (trtable != NULL))
 	return trtable[ch];
 
-      trtable = state->word_trtable;
+      trtable = load_acquire (&state->word_trtable);
       if (__glibc_likely (trtable != NULL))
 	{
 	  unsigned int context;
@@ -3248,6 +3418,25 @@ expand_bkref_cache (re_match_context_t *mctx, re_node_set *cur_nodes,
   return REG_NOERROR;
 }
 
+/* Make TRTABLE the transition table of STATE, or its word transition
+   table if WORD, unless another thread matching with DFA built one for
+   STATE meanwhile.  The table is freed in that case.  */
+
+static void
+publish_trtable (const re_dfa_t *dfa, re_dfastate_t *state,
+		 re_dfastate_t **trtable, bool word)
+{
+  lock_lock (((re_dfa_t *) dfa)->state_lock);
+  if (state->trtable == NULL && state->word_trtable == NULL)
+    {
+      store_release (word ? &state->word_trtable : &state->trtable,
+		     trtable);
+      trtable = NULL;
+    }
+  lock_unlock (((re_dfa_t *) dfa)->state_lock);
+  re_free (trtable);
+}
+
 /* Build transition table for the state.
    Return true if successful.  */
 
@@ -3290,9 +3479,6 @@ build_trtable (const re_dfa_t *dfa, re_dfastate_t *state)
   dests_node = dests_alloc->dests_node;
   dests_ch = dests_alloc->dests_ch;
 
-  /* Initialize transition table.  */
-  state->word_trtable = state->trtable = NULL;
-
   /* At first, group all nodes belonging to 'state' into several
      destinations.  */
   ndests = group_nodes_into_DFAstates (dfa, state, dests_node, dests_ch);
@@ -3303,10 +3489,11 @@ build_trtable (const re_dfa_t *dfa, re_dfastate_t *state)
       /* Return false in case of an error, true otherwise.  */
       if (ndests == 0)
 	{
-	  state->trtable = (re_dfastate_t **)
+	  trtable = (re_dfastate_t **)
 	    calloc (sizeof (re_dfastate_t *), SBC_MAX);
-          if (__glibc_unlikely (state->trtable == NULL))
+          if (__glibc_unlikely (trtable == NULL))
             return false;
+	  publish_trtable (dfa, state, trtable, false);
 	  return true;
 	}
       return false;
@@ -3399,7 +3586,7 @@ out_free:
 	 character, or we are in a single-byte character set so we can
 	 discern by looking at the character code: allocate a
 	 256-entry transition table.  */
-      trtable = state->trtable =
+      trtable =
 	(re_dfastate_t **) calloc (sizeof (re_dfastate_t *), SBC_MAX);
       if (__glibc_unlikely (trtable == NULL))
 	goto out_free;
@@ -3430,7 +3617,7 @@ out_free:
 	 by looking at the character code: build two 256-entry
 	 transition tables, one starting at trtable[0] and one
 	 starting at trtable[SBC_MAX].  */
-      trtable = state->word_trtable =
+      trtable =
 	(re_dfastate_t **) calloc (sizeof (re_dfastate_t *), 2 * SBC_MAX);
       if (__glibc_unlikely (trtable == NULL))
 	goto out_free;
@@ -3470,6 +3657,8 @@ out_free:
 	  }
     }
 
+  publish_trtable (dfa, state, trtable, need_word_trtable);
+
   if (dest_states_malloced)
     re_free (dest_states);
 
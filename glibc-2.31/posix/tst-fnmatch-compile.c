@@ -0,0 +1,148 @@
+/* Test fnmatch_compile and fnmatch_exec against fnmatch.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <fnmatch.h>
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/check.h>
+
+static const char *patterns[] =
+  {
+    "", "*", "?", "a", "abc", "a*", "*c", "a*c", "*b*", "a?c", "*.c",
+    ".*", "*/*", "a/*", "*/b", "a/b", "a/*/c", "**", "a**b", "*a*a*a*b",
+    "[abc]", "[!abc]", "[^abc]", "[]]", "[!]]", "[]-a]", "[a-c]*",
+    "[a-cx-z]?", "[-a]", "[a-]", "[[:alpha:]]*", "[[:digit:][:upper:]]",
+    "[![:space:]]", "[[:foo:]]", "[/]", "[.]*", "*[.]c", "\\*", "a\\?c",
+    "\\[a]", "a\\", "[a\\]]", "[\\!a]", "[", "[a", "a[", "*[", "[[.a.]]",
+    "[[=a=]]", "A*C", "*B*", "[A-C]", "[[:lower:]]x", "*x*y*z*",
+    "a*b*c*d*e*f", "*/", "/*", "*/*/*", ".", "./*", "*.*", "?(a|b)",
+    "*(a)", "@(x)*", "+(a)", "!(b)", "a\\/b", "*\\/b", "\344*", "[\344-\366]",
+    "*\374*",
+  };
+
+static const char *strings[] =
+  {
+    "", "a", "b", "c", "abc", "aBc", "ABC", "ac", "a.c", ".c", "x.c",
+    ".", "..", ".a", "a/b", "a/.b", "a/b/c", "a/x/c", "a//c", "/", "/a",
+    "a/", "ab/cd", "abab/b", "aaaab", "aaaaaaaaaaaaaaaaaaaaaaaaaaaaab",
+    "xyzxyz", "axbyczd", "abcdef", "]", "-", "!", "^", "[", "[a]", "*",
+    "?", "a?c", "\\", "1", "Z", " ", "\t", "x", "a1b2c3d4e5f", "foo/bar",
+    ".hidden/x", "dir/.hidden", "a\\b", "\344", "\344b", "b\374c",
+    "\303\244",
+  };
+
+static const int flag_sets[] =
+  {
+    0, FNM_PATHNAME, FNM_PERIOD, FNM_PATHNAME | FNM_PERIOD, FNM_NOESCAPE,
+    FNM_CASEFOLD, FNM_LEADING_DIR, FNM_PATHNAME | FNM_LEADING_DIR,
+    FNM_PATHNAME | FNM_PERIOD | FNM_LEADING_DIR, FNM_EXTMATCH,
+    FNM_CASEFOLD | FNM_PATHNAME | FNM_NOESCAPE,
+  };
+
+static void
+check (const char *pattern, const char *string, int flags)
+{
+  fnmatch_t *compiled = fnmatch_compile (pattern, flags);
+  TEST_VERIFY_EXIT (compiled != NULL);
+
+  int expected = fnmatch (pattern, string, flags);
+  int result = fnmatch_exec (compiled, string);
+  if (result != expected)
+    {
+      support_record_failure ();
+      printf ("error: pattern \"%s\", string \"%s\", flags %#x: "
+	      "fnmatch_exec returned %d, fnmatch %d\n",
+	      pattern, string, flags, result, expected);
+    }
+  fnmatch_free (compiled);
+}
+
+/* Compare against fnmatch on short patterns and strings made up from
+   characters which are special to either of them.  */
+static void
+check_random (void)
+{
+  static const char pattern_chars[] = "ab.*?/[]!-\\:";
+  static const char string_chars[] = "abAB./-]\\";
+  char pattern[8];
+  char string[8];
+
+  srandom (1);
+  for (int i = 0; i < 20000; ++i)
+    {
+      int plen = random () % (sizeof (pattern) - 1);
+      int slen = random () % (sizeof (string) - 1);
+
+      for (int j = 0; j < plen; ++j)
+	pattern[j] = pattern_chars[random () % (sizeof (pattern_chars) - 1)];
+      pattern[plen] = '\0';
+      for (int j = 0; j < slen; ++j)
+	string[j] = string_chars[random () % (sizeof (string_chars) - 1)];
+      string[slen] = '\0';
+
+      check (pattern, string,
+	     flag_sets[random () % (sizeof (flag_sets)
+				    / sizeof (flag_sets[0]))]);
+    }
+}
+
+static void
+check_all (void)
+{
+  for (size_t f = 0; f < sizeof (flag_sets) / sizeof (flag_sets[0]); ++f)
+    for (size_t p = 0; p < sizeof (patterns) / sizeof (patterns[0]); ++p)
+      for (size_t s = 0; s < sizeof (strings) / sizeof (strings[0]); ++s)
+	check (patterns[p], strings[s], flag_sets[f]);
+  check_random ();
+}
+
+static int
+do_test (void)
+{
+  check_all ();
+
+  TEST_VERIFY_EXIT (setlocale (LC_ALL, "de_DE.ISO-8859-1") != NULL);
+  check_all ();
+
+  TEST_VERIFY_EXIT (setlocale (LC_ALL, "de_DE.UTF-8") != NULL);
+  check_all ();
+
+  /* A compiled pattern can be used many times.  */
+  fnmatch_t *compiled = fnmatch_compile ("*.[ch]", FNM_PATHNAME);
+  TEST_VERIFY_EXIT (compiled != NULL);
+  TEST_COMPARE (fnmatch_exec (compiled, "fnmatch.c"), 0);
+  TEST_COMPARE (fnmatch_exec (compiled, "fnmatch.h"), 0);
+  TEST_COMPARE (fnmatch_exec (compiled, "fnmatch.o"), FNM_NOMATCH);
+  TEST_COMPARE (fnmatch_exec (compiled, "posix/fnmatch.c"), FNM_NOMATCH);
+  fnmatch_free (compiled);
+
+  /* Without backtracking many stars are not a problem.  */
+  char string[4096];
+  memset (string, 'a', sizeof (string) - 1);
+  string[sizeof (string) - 1] = '\0';
+  compiled = fnmatch_compile ("*a*a*a*a*a*a*a*a*a*a*a*a*a*a*a*a*b", 0);
+  TEST_VERIFY_EXIT (compiled != NULL);
+  TEST_COMPARE (fnmatch_exec (compiled, string), FNM_NOMATCH);
+  fnmatch_free (compiled);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,176 @@
+/* Test glob in directories large enough for compiled patterns.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <glob.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/temp_file.h>
+#include <support/xunistd.h>
+
+/* glob compiles the pattern once a directory has 128 entries.  The
+   large directory has more, the small one has fewer, and both contain
+   the entries below.  */
+enum { large_count = 200, small_count = 20 };
+
+static const char *const special_names[] =
+  {
+    ".hidden", ".1", "..x", "a]b", "[x", "\\z", "x-y", "Upper", "-",
+  };
+#define NSPECIAL (sizeof (special_names) / sizeof (special_names[0]))
+
+static const char *const patterns[] =
+  {
+    "file[0-9]*", "*[13579].txt", "[!f]*", "[.]*", "?[a-z]*",
+    "*[[:digit:]]", "*[[:upper:]]*", "[]]*", "*[]]*", "[\\]]*",
+    "\\[*", "[\\\\]*", "\\\\*", "[[]*", "*[!a-z0-9.]*", "[-]",
+    "[a-]*", "*", ".*", "?", "??", "*[x-y]",
+  };
+#define NPATTERNS (sizeof (patterns) / sizeof (patterns[0]))
+
+static const int flag_sets[] =
+  {
+    0, GLOB_PERIOD, GLOB_NOESCAPE, GLOB_PERIOD | GLOB_NOESCAPE,
+  };
+#define NFLAG_SETS (sizeof (flag_sets) / sizeof (flag_sets[0]))
+
+struct dir
+{
+  char *path;
+  char **names;
+  size_t count;
+};
+
+static void
+make_file (struct dir *dir, const char *name)
+{
+  char *path = xasprintf ("%s/%s", dir->path, name);
+  xclose (xopen (path, O_WRONLY | O_CREAT | O_EXCL, 0600));
+  add_temp_file (path);
+  free (path);
+  dir->names[dir->count++] = xstrdup (name);
+}
+
+static void
+make_dir (struct dir *dir, const char *base, size_t nfiles)
+{
+  dir->path = support_create_temp_directory (base);
+  /* Also account for "." and "..".  */
+  dir->names = xmalloc ((nfiles + NSPECIAL + 2) * sizeof (char *));
+  dir->count = 0;
+  dir->names[dir->count++] = xstrdup (".");
+  dir->names[dir->count++] = xstrdup ("..");
+  for (size_t i = 0; i < NSPECIAL; ++i)
+    make_file (dir, special_names[i]);
+  for (size_t i = 0; i < nfiles; ++i)
+    {
+      /* Spread dotfiles and special characters over the directory, so
+	 that some of them are read after the pattern is compiled.  */
+      static const char *const formats[] =
+	{ "file%03zu.txt", "file%03zu.c", ".file%03zu", "a]%03zu",
+	  "\\%03zu-X" };
+      char *name = xasprintf (formats[i % 5], i);
+      make_file (dir, name);
+      free (name);
+    }
+}
+
+static int
+compare_strings (const void *a, const void *b)
+{
+  return strcmp (*(char *const *) a, *(char *const *) b);
+}
+
+/* Compare the result of glob for PATTERN in DIR with FLAGS against
+   fnmatch on each entry of DIR.  */
+static void
+check_glob (const struct dir *dir, const char *pattern, int flags)
+{
+  int fnm_flags = ((flags & GLOB_PERIOD ? 0 : FNM_PERIOD)
+		   | (flags & GLOB_NOESCAPE ? FNM_NOESCAPE : 0));
+  char **expected = xmalloc (dir->count * sizeof (char *));
+  size_t nexpected = 0;
+  for (size_t i = 0; i < dir->count; ++i)
+    if (fnmatch (pattern, dir->names[i], fnm_flags) == 0)
+      expected[nexpected++] = xasprintf ("%s/%s", dir->path,
+					 dir->names[i]);
+  qsort (expected, nexpected, sizeof (char *), compare_strings);
+
+  char *full_pattern = xasprintf ("%s/%s", dir->path, pattern);
+  glob_t g;
+  int ret = glob (full_pattern, flags | GLOB_NOSORT, NULL, &g);
+  if (nexpected == 0)
+    TEST_COMPARE (ret, GLOB_NOMATCH);
+  else
+    {
+      TEST_COMPARE (ret, 0);
+      if (ret == 0)
+	{
+	  qsort (g.gl_pathv, g.gl_pathc, sizeof (char *), compare_strings);
+	  bool same = g.gl_pathc == nexpected;
+	  for (size_t i = 0; same && i < nexpected; ++i)
+	    same = strcmp (g.gl_pathv[i], expected[i]) == 0;
+	  if (!same)
+	    {
+	      support_record_failure ();
+	      printf ("error: pattern \"%s\", flags 0x%x, %zu entries:"
+		      " %zu matches, expected %zu\n",
+		      pattern, flags, dir->count, g.gl_pathc, nexpected);
+	    }
+	  globfree (&g);
+	}
+    }
+
+  free (full_pattern);
+  for (size_t i = 0; i < nexpected; ++i)
+    free (expected[i]);
+  free (expected);
+}
+
+static int
+do_test (void)
+{
+  struct dir large;
+  struct dir small;
+  make_dir (&large, "tst-glob-compiled-large-", large_count);
+  make_dir (&small, "tst-glob-compiled-small-", small_count);
+
+  for (size_t i = 0; i < NPATTERNS; ++i)
+    for (size_t j = 0; j < NFLAG_SETS; ++j)
+      {
+	check_glob (&large, patterns[i], flag_sets[j]);
+	check_glob (&small, patterns[i], flag_sets[j]);
+      }
+
+  for (size_t i = 0; i < large.count; ++i)
+    free (large.names[i]);
+  free (large.names);
+  free (large.path);
+  for (size_t i = 0; i < small.count; ++i)
+    free (small.names[i]);
+  free (small.names);
+  free (small.path);
+  return 0;
+}
+
+#include <support/test-driver.c>
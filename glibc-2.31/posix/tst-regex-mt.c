@@ -0,0 +1,87 @@
+/* Test concurrent regexec calls with one compiled pattern.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <regex.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <support/check.h>
+#include <support/xthread.h>
+
+enum { nthreads = 8, niterations = 2000 };
+
+/* The DFA states of these patterns are built lazily while matching,
+   so the threads race to add states and transition tables.  */
+static const char *const patterns[] =
+  {
+    "([a-z]+)@([a-z]+)\\.(com|org|net)",
+    "(a|b)*abb(a|b)*",
+    "\\<[0-9]+\\>",
+  };
+
+static regex_t regs[sizeof (patterns) / sizeof (patterns[0])];
+
+static void *
+thread_func (void *closure)
+{
+  unsigned int id = (unsigned int) (uintptr_t) closure;
+  char buf[64];
+  regmatch_t m[4];
+
+  for (int i = 0; i < niterations; ++i)
+    {
+      unsigned int n = id * niterations + i;
+
+      snprintf (buf, sizeof (buf), "mail: user%c@host%c.org!",
+		'a' + n % 26, 'a' + (n / 26) % 26);
+      TEST_COMPARE (regexec (&regs[0], buf, 4, m, 0), 0);
+      TEST_COMPARE (m[0].rm_so, 6);
+      TEST_COMPARE (m[0].rm_eo, 21);
+      TEST_COMPARE (m[3].rm_so, 18);
+
+      snprintf (buf, sizeof (buf), "%c%cabb%c",
+		"ab"[n % 2], "ab"[(n / 2) % 2], "ab"[(n / 4) % 2]);
+      TEST_COMPARE (regexec (&regs[1], buf, 1, m, 0), 0);
+      TEST_COMPARE (m[0].rm_so, 0);
+      TEST_COMPARE (m[0].rm_eo, 6);
+
+      snprintf (buf, sizeof (buf), "x%u %u", n, n);
+      TEST_COMPARE (regexec (&regs[2], buf, 1, m, 0), 0);
+      TEST_VERIFY (m[0].rm_so > 1);
+    }
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  for (size_t i = 0; i < sizeof (patterns) / sizeof (patterns[0]); ++i)
+    TEST_COMPARE (regcomp (&regs[i], patterns[i], REG_EXTENDED), 0);
+
+  pthread_t threads[nthreads];
+  for (int i = 0; i < nthreads; ++i)
+    threads[i] = xpthread_create (NULL, thread_func,
+				  (void *) (uintptr_t) i);
+  for (int i = 0; i < nthreads; ++i)
+    xpthread_join (threads[i]);
+
+  for (size_t i = 0; i < sizeof (patterns) / sizeof (patterns[0]); ++i)
+    regfree (&regs[i]);
+  return 0;
+}
+
+#include <support/test-driver.c>
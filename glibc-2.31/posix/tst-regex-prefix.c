@@ -0,0 +1,94 @@
+/* Test regexec on patterns which start with a literal prefix.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <regex.h>
+#include <string.h>
+#include <support/check.h>
+
+static const struct
+{
+  const char *pattern;
+  int cflags;
+  const char *string;
+  regoff_t so;
+  regoff_t eo;
+} tests[] =
+  {
+    { "abc", REG_EXTENDED, "xxabxabcabc", 5, 8 },
+    { "abc", REG_EXTENDED, "xxabxab", -1, -1 },
+    { "ab*c", REG_EXTENDED, "xxacxabbbc", 2, 4 },
+    { "a(b|c)d", REG_EXTENDED, "abcacdabd", 3, 6 },
+    { "foo|bar", REG_EXTENDED, "xxbarfoo", 2, 5 },
+    { "x", REG_EXTENDED, "abcdefghx", 8, 9 },
+    { "hello world", REG_EXTENDED, "say hello hello world", 10, 21 },
+    { "abcdefghijklmnopqrstuvwxyz", REG_EXTENDED,
+      "abcdefghijklmnopqrstuvwxy abcdefghijklmnopqrstuvwxyz", 26, 52 },
+    { "a\\bb", REG_EXTENDED, "ab a b", -1, -1 },
+    { "a\\b", REG_EXTENDED, "ab a b", 3, 4 },
+    { "^abc", REG_EXTENDED, "xabc", -1, -1 },
+    { "abc$", REG_EXTENDED, "abcxabc", 4, 7 },
+    { "abc", REG_EXTENDED | REG_ICASE, "xxABC", 2, 5 },
+    { "a\\(b\\)\\1", 0, "abaabb", 3, 6 },
+  };
+
+static int
+do_test (void)
+{
+  for (size_t i = 0; i < sizeof (tests) / sizeof (tests[0]); ++i)
+    {
+      regex_t re;
+      regmatch_t m;
+      TEST_COMPARE (regcomp (&re, tests[i].pattern, tests[i].cflags), 0);
+      int ret = regexec (&re, tests[i].string, 1, &m, 0);
+      if (tests[i].so == -1)
+	TEST_COMPARE (ret, REG_NOMATCH);
+      else
+	{
+	  TEST_COMPARE (ret, 0);
+	  TEST_COMPARE (m.rm_so, tests[i].so);
+	  TEST_COMPARE (m.rm_eo, tests[i].eo);
+	}
+
+      /* The prefix must not be found beyond the end of the string
+	 passed with REG_STARTEND.  */
+      m.rm_so = 0;
+      m.rm_eo = strlen (tests[i].string) - 1;
+      ret = regexec (&re, tests[i].string, 1, &m, REG_STARTEND);
+      if (tests[i].so == -1
+	  || (size_t) tests[i].eo > strlen (tests[i].string) - 1)
+	TEST_COMPARE (ret, REG_NOMATCH);
+      else
+	TEST_COMPARE (ret, 0);
+      regfree (&re);
+    }
+
+  /* Matches starting at the end of the range are still found with
+     re_search.  */
+  struct re_pattern_buffer buf;
+  memset (&buf, 0, sizeof (buf));
+  re_set_syntax (RE_SYNTAX_POSIX_EXTENDED);
+  TEST_VERIFY (re_compile_pattern ("abc", 3, &buf) == NULL);
+  TEST_COMPARE (re_search (&buf, "xxxabc", 6, 0, 3, NULL), 3);
+  TEST_COMPARE (re_search (&buf, "xxxabc", 6, 0, 2, NULL), -1);
+  TEST_COMPARE (re_search (&buf, "xxxabc", 5, 0, 3, NULL), -1);
+  regfree (&buf);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,135 @@
+/* Test regset_comp and regset_exec.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <locale.h>
+#include <regex.h>
+#include <stdio.h>
+#include <string.h>
+#include <support/check.h>
+
+#define NPATTERNS(p) (sizeof (p) / sizeof ((p)[0]))
+
+/* Check that SET reports the matches in EXPECTED, which has one
+   character '0' or '1' per pattern, for STRING.  Every result is
+   compared with regexec on the pattern compiled on its own.  */
+static void
+check (const regset_t *set, const char *const *patterns, size_t npatterns,
+       int cflags, const char *string, int eflags, const char *expected)
+{
+  char matched[npatterns];
+  int any = 0;
+
+  memset (matched, 2, npatterns);
+  int ret = regset_exec (set, string, matched, eflags);
+  for (size_t i = 0; i < npatterns; ++i)
+    {
+      regex_t re;
+      TEST_COMPARE (regcomp (&re, patterns[i], cflags | REG_NOSUB), 0);
+      int single = regexec (&re, string, 0, NULL, eflags) == 0;
+      regfree (&re);
+
+      if (matched[i] != single || matched[i] != expected[i] - '0')
+	{
+	  support_record_failure ();
+	  printf ("error: pattern \"%s\", string \"%s\": matched %d,"
+		  " regexec %d, expected %c\n", patterns[i], string,
+		  matched[i], single, expected[i]);
+	}
+      any |= single;
+    }
+  TEST_COMPARE (ret, any ? 0 : REG_NOMATCH);
+}
+
+static int
+do_test (void)
+{
+  static const char *const patterns[] =
+    {
+      "abc", "^foo", "bar$", "[0-9]+x", "a|b*", "\\<word\\>", "^$",
+      "(ab|cd)+e", "z{2,3}q"
+    };
+  regset_t set;
+
+  for (int n = 0; n < 2; ++n)
+    {
+      TEST_COMPARE (regset_comp (&set, patterns, NPATTERNS (patterns),
+				 REG_EXTENDED), 0);
+      check (&set, patterns, NPATTERNS (patterns), REG_EXTENDED,
+	     "foo abc bar", 0, "111010000");
+      check (&set, patterns, NPATTERNS (patterns), REG_EXTENDED,
+	     "foo abc bar", REG_NOTBOL | REG_NOTEOL, "100010000");
+      check (&set, patterns, NPATTERNS (patterns), REG_EXTENDED,
+	     "a word, 12x, cdabe zzzq", 0, "000111011");
+      check (&set, patterns, NPATTERNS (patterns), REG_EXTENDED,
+	     "", 0, "000010100");
+      check (&set, patterns, NPATTERNS (patterns), REG_EXTENDED,
+	     "swordfish zzq\xe4\xff", 0, "000010001");
+      regset_free (&set);
+
+      /* Repeat the checks in a UTF-8 locale.  */
+      if (n == 0 && setlocale (LC_ALL, "de_DE.UTF-8") == NULL)
+	FAIL_EXIT1 ("setlocale (LC_ALL, \"de_DE.UTF-8\") failed");
+    }
+
+  /* Periods match multibyte characters.  */
+  static const char *const utf8[] = { "b.r$", "\xc3\xa4x", "^.x", "a.b" };
+  TEST_COMPARE (regset_comp (&set, utf8, NPATTERNS (utf8), REG_EXTENDED), 0);
+  check (&set, utf8, NPATTERNS (utf8), REG_EXTENDED,
+	 "\xc3\xa4x b\xc3\xa4r", 0, "1110");
+  check (&set, utf8, NPATTERNS (utf8), REG_EXTENDED,
+	 "a\xc3\xa4\xc3\xa4" "b b\xc3" "r", 0, "0000");
+  regset_free (&set);
+
+  setlocale (LC_ALL, "C");
+
+  /* REG_NEWLINE and REG_ICASE.  */
+  static const char *const lines[] = { "^foo$", "BAR", "^b.r" };
+  TEST_COMPARE (regset_comp (&set, lines, NPATTERNS (lines),
+			     REG_NEWLINE | REG_ICASE), 0);
+  check (&set, lines, NPATTERNS (lines), REG_NEWLINE | REG_ICASE,
+	 "x\nFoo\nbar", 0, "111");
+  check (&set, lines, NPATTERNS (lines), REG_NEWLINE | REG_ICASE,
+	 "x foo\nb\nr", 0, "000");
+  regset_free (&set);
+
+  /* Back-references are matched one pattern at a time.  */
+  static const char *const backrefs[] = { "\\(a*\\)b\\1$", "c", "^x" };
+  TEST_COMPARE (regset_comp (&set, backrefs, NPATTERNS (backrefs), 0), 0);
+  check (&set, backrefs, NPATTERNS (backrefs), 0, "xaabaa", 0, "101");
+  check (&set, backrefs, NPATTERNS (backrefs), 0, "aabac", 0, "010");
+  regset_free (&set);
+
+  /* A back-reference must not refer to a subexpression of another
+     pattern.  */
+  static const char *const badref[] = { "(a)", "\\1" };
+  TEST_COMPARE (regset_comp (&set, badref, NPATTERNS (badref),
+			     REG_EXTENDED), REG_ESUBREG);
+
+  static const char *const bad[] = { "a", "b(" };
+  TEST_COMPARE (regset_comp (&set, bad, NPATTERNS (bad), REG_EXTENDED),
+		REG_EPAREN);
+
+  /* An empty set never matches.  */
+  TEST_COMPARE (regset_comp (&set, NULL, 0, 0), 0);
+  TEST_COMPARE (regset_exec (&set, "abc", NULL, 0), REG_NOMATCH);
+  regset_free (&set);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,299 @@
+/* In-process cache of DNS responses (RES_CACHE).
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <arpa/nameser.h>
+#include <libc-lock.h>
+#include <netinet/in.h>
+#include <resolv-internal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Responses are cached under a key made of the name server addresses
+   and the query without its transaction ID.  Including the name
+   servers keeps applications which direct queries to different
+   servers apart, and drops the cached data implicitly when
+   /etc/resolv.conf lists new servers.  The query includes the header
+   flags and the EDNS record, so queries which request different
+   processing do not share responses either.  */
+
+enum
+  {
+    /* Upper bound for the total size of the cached data.  The oldest
+       entries are removed to make room for new ones.  */
+    CACHE_MAX_SIZE = 256 * 1024,
+
+    /* Upper bound for the time a response is cached, in seconds.  */
+    CACHE_MAX_TTL = 3600,
+
+    /* Queries longer than this are not cached.  */
+    CACHE_MAX_QUERY = PACKETSZ,
+
+    /* Space for the name server part of the key.  */
+    CACHE_MAX_SERVERS_KEY = MAXNS * (1 + 2 + 16 + 4),
+
+    CACHE_BUCKETS = 256,
+  };
+
+struct cache_entry
+{
+  /* Next entry in the same hash bucket.  */
+  struct cache_entry *next;
+  /* Neighbors in the list of all entries, from oldest to newest.  */
+  struct cache_entry *older;
+  struct cache_entry *newer;
+
+  uint32_t hash;
+  time_t expires;		/* CLOCK_MONOTONIC seconds.  */
+  size_t keylen;
+  size_t anslen;
+  unsigned char data[];		/* The key, followed by the response.  */
+};
+
+/* Protects all the variables below.  */
+__libc_lock_define_initialized (static, lock);
+static struct cache_entry *buckets[CACHE_BUCKETS];
+static struct cache_entry *oldest;
+static struct cache_entry *newest;
+static size_t cache_size;
+
+/* Write the key for QUERY sent to the name servers of STATP to KEY.
+   Return its length, or 0 if the query is not cached.  */
+static size_t
+make_key (const struct __res_state *statp, const unsigned char *query,
+	  int querylen,
+	  unsigned char key[CACHE_MAX_SERVERS_KEY + CACHE_MAX_QUERY])
+{
+  if (querylen <= HFIXEDSZ || querylen > CACHE_MAX_QUERY)
+    return 0;
+
+  unsigned char *p = key;
+  for (int ns = 0; ns < statp->nscount && ns < MAXNS; ++ns)
+    {
+      const struct sockaddr_in *sin = &statp->nsaddr_list[ns];
+      const struct sockaddr_in6 *sin6 = statp->_u._ext.nsaddrs[ns];
+
+      if (sin->sin_family == AF_INET)
+	{
+	  *p++ = 4;
+	  p = mempcpy (p, &sin->sin_port, sizeof (sin->sin_port));
+	  p = mempcpy (p, &sin->sin_addr, sizeof (sin->sin_addr));
+	}
+      else if (sin6 != NULL && sin6->sin6_family == AF_INET6)
+	{
+	  *p++ = 6;
+	  p = mempcpy (p, &sin6->sin6_port, sizeof (sin6->sin6_port));
+	  p = mempcpy (p, &sin6->sin6_addr, sizeof (sin6->sin6_addr));
+	  p = mempcpy (p, &sin6->sin6_scope_id,
+		       sizeof (sin6->sin6_scope_id));
+	}
+      else
+	*p++ = 0;
+    }
+
+  /* Skip the transaction ID.  */
+  p = mempcpy (p, query + 2, querylen - 2);
+  return p - key;
+}
+
+static uint32_t
+hash_key (const unsigned char *key, size_t keylen)
+{
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < keylen; ++i)
+    hash = (hash ^ key[i]) * 16777619u;
+  return hash;
+}
+
+/* Return the number of seconds for which ANSWER may be cached, or 0
+   if it must not be cached.  Positive responses are cached for the
+   minimum TTL of their answer records, negative ones as specified in
+   RFC 2308.  */
+static unsigned int
+response_ttl (const unsigned char *answer, int anslen)
+{
+  ns_msg handle;
+  ns_rr rr;
+
+  if (ns_initparse (answer, anslen, &handle) < 0
+      || ns_msg_getflag (handle, ns_f_qr) == 0
+      || ns_msg_getflag (handle, ns_f_opcode) != ns_o_query
+      || ns_msg_getflag (handle, ns_f_tc) != 0)
+    return 0;
+
+  int rcode = ns_msg_getflag (handle, ns_f_rcode);
+  unsigned int ttl = CACHE_MAX_TTL;
+  if (rcode == ns_r_noerror && ns_msg_count (handle, ns_s_an) > 0)
+    {
+      for (int i = 0; i < ns_msg_count (handle, ns_s_an); ++i)
+	{
+	  if (ns_parserr (&handle, ns_s_an, i, &rr) < 0)
+	    return 0;
+	  if (ns_rr_ttl (rr) < ttl)
+	    ttl = ns_rr_ttl (rr);
+	}
+      return ttl;
+    }
+
+  if (rcode != ns_r_noerror && rcode != ns_r_nxdomain)
+    return 0;
+
+  /* A negative response can only be cached if the authority section
+     has an SOA record.  */
+  for (int i = 0; i < ns_msg_count (handle, ns_s_ns); ++i)
+    {
+      if (ns_parserr (&handle, ns_s_ns, i, &rr) < 0)
+	return 0;
+      if (ns_rr_type (rr) == ns_t_soa && ns_rr_rdlen (rr) >= NS_INT32SZ)
+	{
+	  /* The MINIMUM field is the last one.  */
+	  unsigned int minimum
+	    = ns_get32 (ns_rr_rdata (rr) + ns_rr_rdlen (rr) - NS_INT32SZ);
+	  if (ns_rr_ttl (rr) < ttl)
+	    ttl = ns_rr_ttl (rr);
+	  if (minimum < ttl)
+	    ttl = minimum;
+	  return ttl;
+	}
+    }
+  return 0;
+}
+
+static time_t
+now (void)
+{
+  struct timespec ts;
+  __clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec;
+}
+
+/* Remove E from the cache and free it.  *LINK must point to E.  */
+static void
+remove_entry (struct cache_entry **link, struct cache_entry *e)
+{
+  *link = e->next;
+  if (e->older != NULL)
+    e->older->newer = e->newer;
+  else
+    oldest = e->newer;
+  if (e->newer != NULL)
+    e->newer->older = e->older;
+  else
+    newest = e->older;
+  cache_size -= e->keylen + e->anslen;
+  free (e);
+}
+
+/* Return a pointer to the link to the entry for KEY, or to the end of
+   its bucket if there is none.  */
+static struct cache_entry **
+find_entry (const unsigned char *key, size_t keylen, uint32_t hash)
+{
+  struct cache_entry **link = &buckets[hash % CACHE_BUCKETS];
+  while (*link != NULL
+	 && ((*link)->hash != hash || (*link)->keylen != keylen
+	     || memcmp ((*link)->data, key, keylen) != 0))
+    link = &(*link)->next;
+  return link;
+}
+
+int
+__res_cache_lookup (const struct __res_state *statp,
+		    const unsigned char *query, int querylen,
+		    unsigned char *answer, int anssiz)
+{
+  unsigned char key[CACHE_MAX_SERVERS_KEY + CACHE_MAX_QUERY];
+  size_t keylen = make_key (statp, query, querylen, key);
+  if (keylen == 0)
+    return 0;
+  uint32_t hash = hash_key (key, keylen);
+  int result = 0;
+
+  __libc_lock_lock (lock);
+
+  struct cache_entry **link = find_entry (key, keylen, hash);
+  struct cache_entry *e = *link;
+  if (e != NULL && e->expires <= now ())
+    {
+      remove_entry (link, e);
+      e = NULL;
+    }
+  if (e != NULL)
+    {
+      result = e->anslen;
+      if (anssiz >= 0 && e->anslen <= (size_t) anssiz)
+	{
+	  memcpy (answer, e->data + keylen, e->anslen);
+	  /* Use the transaction ID of the query.  */
+	  memcpy (answer, query, 2);
+	}
+    }
+
+  __libc_lock_unlock (lock);
+
+  return result;
+}
+
+void
+__res_cache_store (const struct __res_state *statp,
+		   const unsigned char *query, int querylen,
+		   const unsigned char *answer, int anslen)
+{
+  unsigned char key[CACHE_MAX_SERVERS_KEY + CACHE_MAX_QUERY];
+  size_t keylen = make_key (statp, query, querylen, key);
+  if (keylen == 0 || keylen + anslen > CACHE_MAX_SIZE / 8)
+    return;
+  unsigned int ttl = response_ttl (answer, anslen);
+  if (ttl == 0)
+    return;
+
+  struct cache_entry *new = malloc (sizeof (*new) + keylen + anslen);
+  if (new == NULL)
+    return;
+  new->hash = hash_key (key, keylen);
+  new->keylen = keylen;
+  new->anslen = anslen;
+  memcpy (mempcpy (new->data, key, keylen), answer, anslen);
+
+  __libc_lock_lock (lock);
+
+  new->expires = now () + ttl;
+
+  /* Replace the old response, if any.  */
+  struct cache_entry **link = find_entry (key, keylen, new->hash);
+  if (*link != NULL)
+    remove_entry (link, *link);
+
+  while (oldest != NULL && cache_size + keylen + anslen > CACHE_MAX_SIZE)
+    remove_entry (find_entry (oldest->data, oldest->keylen, oldest->hash),
+		  oldest);
+
+  new->next = buckets[new->hash % CACHE_BUCKETS];
+  buckets[new->hash % CACHE_BUCKETS] = new;
+  new->older = newest;
+  new->newer = NULL;
+  if (newest != NULL)
+    newest->newer = new;
+  else
+    oldest = new;
+  newest = new;
+  cache_size += keylen + anslen;
+
+  __libc_lock_unlock (lock);
+}
@@ -341,6 +341,49 @@ mask_ad_bit (struct resolv_context *ctx, void *buf)
     ((HEADER *) buf)->ad = 0;
 }
 
+/* Try to answer the queries from the RES_CACHE cache.  The arguments
+   are those of __res_context_send.  Return the length of the first
+   response if both responses were found, otherwise 0.  */
+static int
+send_from_cache (struct resolv_context *ctx,
+		 const unsigned char *buf, int buflen,
+		 const unsigned char *buf2, int buflen2,
+		 unsigned char *ans, int anssiz,
+		 unsigned char **ansp, unsigned char **ansp2,
+		 int *nansp2, int *resplen2, int *ansp2_malloced)
+{
+  if (ansp != NULL)
+    ans = *ansp;
+  int n = __res_cache_lookup (ctx->resp, buf, buflen, ans, anssiz);
+  if (n <= HFIXEDSZ || n > anssiz)
+    return 0;
+
+  if (buf2 != NULL)
+    {
+      int n2 = __res_cache_lookup (ctx->resp, buf2, buflen2,
+				   *ansp2, *nansp2);
+      if (n2 > *nansp2 && !*ansp2_malloced)
+	{
+	  /* Allocate the second buffer as send_dg would.  */
+	  unsigned char *newp = malloc (MAXPACKET);
+	  if (newp == NULL)
+	    return 0;
+	  *ansp2 = newp;
+	  *nansp2 = MAXPACKET;
+	  *ansp2_malloced = 1;
+	  n2 = __res_cache_lookup (ctx->resp, buf2, buflen2,
+				   *ansp2, *nansp2);
+	}
+      if (n2 <= HFIXEDSZ || n2 > *nansp2)
+	return 0;
+      mask_ad_bit (ctx, *ansp2);
+      *resplen2 = n2;
+    }
+
+  mask_ad_bit (ctx, ans);
+  return n;
+}
+
 /* int
  * res_queriesmatch(buf1, eom1, buf2, eom2)
  *	is there a 1:1 mapping of (name,type,class)
@@ -484,6 +527,14 @@ __res_context_send (struct resolv_context *ctx,
 		EXT(statp).nscount = statp->nscount;
 	}
 
+	if (statp->options & RES_CACHE) {
+		n = send_from_cache (ctx, buf, buflen, buf2, buflen2,
+				     ans, anssiz, ansp, ansp2, nansp2,
+				     resplen2, ansp2_malloced);
+		if (n > 0)
+			return (n);
+	}
+
 	/* Name server index offset.  Used to implement
 	   RES_ROTATE.  */
 	unsigned int ns_offset = nameserver_offset (statp);
@@ -537,6 +588,17 @@ __res_context_send (struct resolv_context *ctx,
 		/* See comment at the declaration of n.  Note: resplen = n;  */
 		DIAG_PUSH_NEEDS_COMMENT;
 		DIAG_IGNORE_NEEDS_COMMENT (9, "-Wmaybe-uninitialized");
+		/* Cache the responses as received, so that later
+		   changes to RES_TRUSTAD are honored.  */
+		if (statp->options & RES_CACHE) {
+			__res_cache_store (statp, buf, buflen,
+					   ansp != NULL ? *ansp : ans,
+					   resplen);
+			if (buf2 != NULL && *resplen2 > HFIXEDSZ)
+				__res_cache_store (statp, buf2, buflen2,
+						   *ansp2, *resplen2);
+		}
+
 		/* Mask the AD bit in both responses unless it is
 		   marked trusted.  */
 		if (resplen > HFIXEDSZ)
@@ -76,6 +76,21 @@ int __res_context_send (struct resolv_context *, const unsigned char *, int,
                         int, unsigned char **, unsigned char **,
                         int *, int *, int *) attribute_hidden;
 
+/* Look up the cached response to QUERY for the name servers in the
+   resolver state (RES_CACHE).  Return the length of the response, or
+   0 if there is none.  The response is copied to ANSWER, with the
+   transaction ID of QUERY, only if it fits into ANSSIZ bytes.  */
+int __res_cache_lookup (const struct __res_state *,
+                        const unsigned char *query, int querylen,
+                        unsigned char *answer, int anssiz) attribute_hidden;
+
+/* Add the response ANSWER to QUERY to the cache, if it is
+   cacheable.  */
+void __res_cache_store (const struct __res_state *,
+                        const unsigned char *query, int querylen,
+                        const unsigned char *answer, int anslen)
+  attribute_hidden;
+
 /* Internal function similar to res_hostalias.  */
 const char *__res_context_hostalias (struct resolv_context *,
                                      const char *, char *, size_t);
@@ -0,0 +1,231 @@
+/* Test the behavior of the cache option.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <netdb.h>
+#include <resolv.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/check_nss.h>
+#include <support/resolv_test.h>
+#include <support/support.h>
+#include <unistd.h>
+
+/* Number of queries received by the server.  volatile because
+   __res_send is incorrectly declared as __THROW.  */
+static volatile int queries;
+
+/* Changes with each response, to tell cached responses apart.  */
+static volatile unsigned char response_number;
+
+static void
+response (const struct resolv_response_context *ctx,
+          struct resolv_response_builder *b,
+          const char *qname, uint16_t qclass, uint16_t qtype)
+{
+  TEST_COMPARE (qclass, C_IN);
+  ++queries;
+
+  struct resolv_response_flags flags = { };
+  if (strcmp (qname, "servfail.example") == 0)
+    flags.rcode = ns_r_servfail;
+  else if (strcmp (qname, "nxdomain.example") == 0
+           || strcmp (qname, "nosoa.example") == 0)
+    flags.rcode = ns_r_nxdomain;
+  resolv_response_init (b, flags);
+  resolv_response_add_question (b, qname, qclass, qtype);
+  if (flags.rcode == ns_r_servfail)
+    return;
+
+  if (flags.rcode == ns_r_nxdomain)
+    {
+      if (strcmp (qname, "nxdomain.example") == 0)
+        {
+          resolv_response_section (b, ns_s_ns);
+          resolv_response_open_record (b, "example", qclass, T_SOA, 300);
+          resolv_response_add_name (b, "ns.example");
+          resolv_response_add_name (b, "hostmaster.example");
+          /* Serial, refresh, retry, expire, minimum.  */
+          static const unsigned char soa[] =
+            {
+              0, 0, 0, 1,
+              0, 0, 14, 16,
+              0, 0, 3, 132,
+              0, 9, 58, 128,
+              0, 0, 0, 60,
+            };
+          resolv_response_add_data (b, soa, sizeof (soa));
+          resolv_response_close_record (b);
+        }
+      return;
+    }
+
+  uint32_t ttl = 300;
+  if (strcmp (qname, "zero.example") == 0)
+    ttl = 0;
+  else if (strcmp (qname, "short.example") == 0)
+    /* The cache counts in whole seconds, so an entry can expire up to
+       one second early.  */
+    ttl = 3;
+
+  resolv_response_section (b, ns_s_an);
+  resolv_response_open_record (b, qname, qclass, qtype, ttl);
+  if (qtype == T_A)
+    {
+      char addr[4] = { 192, 0, 2, response_number };
+      resolv_response_add_data (b, addr, sizeof (addr));
+    }
+  else if (qtype == T_AAAA)
+    {
+      char addr[16] = { 0x20, 0x01, 0xd, 0xb8, };
+      addr[15] = response_number;
+      resolv_response_add_data (b, addr, sizeof (addr));
+    }
+  else
+    FAIL_EXIT1 ("unexpected query type %d", qtype);
+  resolv_response_close_record (b);
+}
+
+/* Send an A query for NAME and check the address in the response
+   against EXPECTED_NUMBER.  Return the number of queries which
+   reached the server.  */
+static int
+query_a (const char *name, int expected_number)
+{
+  int before = queries;
+  unsigned char buffer[512];
+  memset (buffer, 255, sizeof (buffer));
+  int ret = res_query (name, C_IN, T_A, buffer, sizeof (buffer));
+  TEST_VERIFY (ret > 0);
+  char *expected = xasprintf ("name: %s\n"
+                              "address: 192.0.2.%d\n",
+                              name, expected_number);
+  check_dns_packet (name, buffer, ret, expected);
+  free (expected);
+  return queries - before;
+}
+
+/* Send an A query for NAME, which is expected to fail with
+   EXPECTED_ERROR.  Return the number of queries which reached the
+   server.  */
+static int
+query_fail (const char *name, int expected_error)
+{
+  int before = queries;
+  unsigned char buffer[512];
+  TEST_COMPARE (res_query (name, C_IN, T_A, buffer, sizeof (buffer)), -1);
+  TEST_COMPARE (h_errno, expected_error);
+  return queries - before;
+}
+
+/* Call getaddrinfo for NAME and return the number of queries which
+   reached the server.  */
+static int
+query_gai (const char *name, int expected_number)
+{
+  int before = queries;
+  struct addrinfo hints =
+    {
+      .ai_family = AF_UNSPEC,
+      .ai_socktype = SOCK_STREAM,
+    };
+  struct addrinfo *ai;
+  int ret = getaddrinfo (name, "80", &hints, &ai);
+  char *expected = xasprintf ("address: STREAM/TCP 192.0.2.%d 80\n"
+                              "address: STREAM/TCP 2001:db8::%x 80\n",
+                              expected_number, expected_number);
+  check_addrinfo (name, ai, ret, expected);
+  free (expected);
+  if (ret == 0)
+    freeaddrinfo (ai);
+  return queries - before;
+}
+
+static int
+do_test (void)
+{
+  struct resolv_test *aux = resolv_test_start
+    ((struct resolv_redirect_config)
+     {
+       .response_callback = response,
+     });
+
+  /* Without the option, every query reaches the server.  */
+  ++response_number;
+  TEST_COMPARE (query_a ("www.example", response_number), 1);
+  ++response_number;
+  TEST_COMPARE (query_a ("www.example", response_number), 1);
+
+  _res.options |= RES_CACHE;
+
+  /* Positive responses are cached.  */
+  ++response_number;
+  TEST_COMPARE (query_a ("www.example", response_number), 1);
+  TEST_COMPARE (query_a ("www.example", response_number), 0);
+  TEST_COMPARE (query_a ("www.example", response_number), 0);
+
+  /* Both responses of an A/AAAA query pair are cached.  */
+  ++response_number;
+  TEST_COMPARE (query_gai ("pair.example", response_number), 2);
+  TEST_COMPARE (query_gai ("pair.example", response_number), 0);
+
+  /* Queries with different flags do not share responses.  */
+  _res.options |= RES_USE_EDNS0;
+  ++response_number;
+  TEST_COMPARE (query_a ("www.example", response_number), 1);
+  TEST_COMPARE (query_a ("www.example", response_number), 0);
+  _res.options &= ~RES_USE_EDNS0;
+  TEST_COMPARE (query_a ("www.example", response_number - 1), 0);
+
+  /* Responses with a TTL of zero are not cached.  */
+  ++response_number;
+  TEST_COMPARE (query_a ("zero.example", response_number), 1);
+  ++response_number;
+  TEST_COMPARE (query_a ("zero.example", response_number), 1);
+
+  /* Cached responses expire.  */
+  ++response_number;
+  TEST_COMPARE (query_a ("short.example", response_number), 1);
+  TEST_COMPARE (query_a ("short.example", response_number), 0);
+  sleep (4);
+  ++response_number;
+  TEST_COMPARE (query_a ("short.example", response_number), 1);
+
+  /* Negative responses are cached only if they come with an SOA
+     record.  */
+  TEST_COMPARE (query_fail ("nxdomain.example", HOST_NOT_FOUND), 1);
+  TEST_COMPARE (query_fail ("nxdomain.example", HOST_NOT_FOUND), 0);
+  TEST_COMPARE (query_fail ("nosoa.example", HOST_NOT_FOUND), 1);
+  TEST_COMPARE (query_fail ("nosoa.example", HOST_NOT_FOUND), 1);
+
+  /* Server failures are never cached.  */
+  int count = query_fail ("servfail.example", TRY_AGAIN);
+  TEST_VERIFY (count > 0);
+  TEST_COMPARE (query_fail ("servfail.example", TRY_AGAIN), count);
+
+  /* Turning off the option bypasses the cache.  */
+  _res.options &= ~RES_CACHE;
+  ++response_number;
+  TEST_COMPARE (query_a ("www.example", response_number), 1);
+
+  resolv_test_end (aux);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
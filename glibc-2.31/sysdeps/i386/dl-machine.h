@@ -25,6 +25,7 @@
 #include <sysdep.h>
 #include <tls.h>
 #include <dl-tlsdesc.h>
+#include <dl-ifunc-cache.h>
 #include <cpu-features.c>
 
 /* Return nonzero iff ELF header is compatible with the running host.  */
@@ -350,7 +351,12 @@ elf_machine_rel (struct link_map *map, const Elf32_Rel *reloc,
 				strtab + refsym->st_name);
 	    }
 # endif
-	  value = ((Elf32_Addr (*) (void)) value) ();
+	  /* Do not cache the result of a resolver which runs before its
+	     object is relocated, it may be wrong.  */
+	  if (sym_map != map && !sym_map->l_relocated)
+	    value = ((Elf32_Addr (*) (void)) value) ();
+	  else
+	    value = _dl_ifunc_cache_call (sym_map, value);
 	}
 
       switch (r_type)
@@ -481,7 +487,7 @@ elf_machine_rel (struct link_map *map, const Elf32_Rel *reloc,
 	case R_386_IRELATIVE:
 	  value = map->l_addr + *reloc_addr;
 	  if (__glibc_likely (!skip_ifunc))
-	    value = ((Elf32_Addr (*) (void)) value) ();
+	    value = _dl_ifunc_cache_call (map, value);
 	  *reloc_addr = value;
 	  break;
 	default:
@@ -516,7 +522,12 @@ elf_machine_rela (struct link_map *map, const Elf32_Rela *reloc,
 	  && __glibc_likely (sym->st_shndx != SHN_UNDEF)
 	  && __glibc_unlikely (ELFW(ST_TYPE) (sym->st_info) == STT_GNU_IFUNC)
 	  && __glibc_likely (!skip_ifunc))
-	value = ((Elf32_Addr (*) (void)) value) ();
+	{
+	  if (sym_map != map && !sym_map->l_relocated)
+	    value = ((Elf32_Addr (*) (void)) value) ();
+	  else
+	    value = _dl_ifunc_cache_call (sym_map, value);
+	}
 
       switch (ELF32_R_TYPE (reloc->r_info))
 	{
@@ -629,7 +640,7 @@ elf_machine_rela (struct link_map *map, const Elf32_Rela *reloc,
 	case R_386_IRELATIVE:
 	  value = map->l_addr + reloc->r_addend;
 	  if (__glibc_likely (!skip_ifunc))
-	    value = ((Elf32_Addr (*) (void)) value) ();
+	    value = _dl_ifunc_cache_call (map, value);
 	  *reloc_addr = value;
 	  break;
 	default:
@@ -732,7 +743,7 @@ elf_machine_lazy_rel (struct link_map *map,
     {
       Elf32_Addr value = map->l_addr + *reloc_addr;
       if (__glibc_likely (!skip_ifunc))
-	value = ((Elf32_Addr (*) (void)) value) ();
+	value = _dl_ifunc_cache_call (map, value);
       *reloc_addr = value;
     }
   else
@@ -763,7 +774,7 @@ elf_machine_lazy_rela (struct link_map *map,
     {
       Elf32_Addr value = map->l_addr + reloc->r_addend;
       if (__glibc_likely (!skip_ifunc))
-	value = ((Elf32_Addr (*) (void)) value) ();
+	value = _dl_ifunc_cache_call (map, value);
       *reloc_addr = value;
     }
   else
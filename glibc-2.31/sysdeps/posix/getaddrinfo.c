@@ -1641,6 +1641,95 @@ in6aicmp (const void *p1, const void *p2)
 }
 
 
+/* Source addresses determined for recently sorted destinations.  The
+   entries are valid as long as the network configuration does not
+   change, that is, while __check_pf_timestamp returns the value in
+   srccache_timestamp.  */
+struct srccache_entry
+{
+  struct sockaddr_in6 dest_addr;
+  socklen_t dest_addr_len;
+  struct sockaddr_in6 source_addr;
+  uint8_t source_addr_len;
+  uint8_t source_addr_flags;
+  uint8_t prefixlen;
+  uint32_t index;
+};
+
+#define SRCCACHE_SIZE 32
+
+__libc_lock_define_initialized (static, srccache_lock);
+static uint32_t srccache_timestamp;
+static unsigned int srccache_used;
+static unsigned int srccache_next;
+static struct srccache_entry srccache[SRCCACHE_SIZE];
+
+/* Fill in the source address information in RESULT for the
+   destination Q from the cache.  TIMESTAMP is the current value of
+   __check_pf_timestamp.  Return true if the destination was found.  */
+static bool
+srccache_lookup (uint32_t timestamp, const struct addrinfo *q,
+		 struct sort_result *result)
+{
+  bool found = false;
+
+  if (timestamp == 0 || q->ai_addrlen > sizeof (srccache[0].dest_addr))
+    return false;
+
+  __libc_lock_lock (srccache_lock);
+  if (srccache_timestamp == timestamp)
+    for (unsigned int i = 0; i < srccache_used; ++i)
+      if (srccache[i].dest_addr_len == q->ai_addrlen
+	  && memcmp (&srccache[i].dest_addr, q->ai_addr, q->ai_addrlen) == 0)
+	{
+	  memcpy (&result->source_addr, &srccache[i].source_addr,
+		  srccache[i].source_addr_len);
+	  result->source_addr_len = srccache[i].source_addr_len;
+	  result->got_source_addr = true;
+	  result->source_addr_flags = srccache[i].source_addr_flags;
+	  result->prefixlen = srccache[i].prefixlen;
+	  result->index = srccache[i].index;
+	  found = true;
+	  break;
+	}
+  __libc_lock_unlock (srccache_lock);
+
+  return found;
+}
+
+/* Add the source address information found in RESULT for Q to the
+   cache.  */
+static void
+srccache_store (uint32_t timestamp, const struct addrinfo *q,
+		const struct sort_result *result)
+{
+  if (timestamp == 0 || q->ai_addrlen > sizeof (srccache[0].dest_addr))
+    return;
+
+  __libc_lock_lock (srccache_lock);
+  if (srccache_timestamp != timestamp)
+    {
+      srccache_timestamp = timestamp;
+      srccache_used = 0;
+      srccache_next = 0;
+    }
+
+  struct srccache_entry *e = &srccache[srccache_next];
+  srccache_next = (srccache_next + 1) % SRCCACHE_SIZE;
+  if (srccache_used < SRCCACHE_SIZE)
+    ++srccache_used;
+
+  memcpy (&e->dest_addr, q->ai_addr, q->ai_addrlen);
+  e->dest_addr_len = q->ai_addrlen;
+  memcpy (&e->source_addr, &result->source_addr, result->source_addr_len);
+  e->source_addr_len = result->source_addr_len;
+  e->source_addr_flags = result->source_addr_flags;
+  e->prefixlen = result->prefixlen;
+  e->index = result->index;
+  __libc_lock_unlock (srccache_lock);
+}
+
+
 /* Name of the config file for RFC 3484 sorting (for now).  */
 #define GAICONF_FNAME "/etc/gai.conf"
 
@@ -2312,6 +2401,10 @@ getaddrinfo (const char *name, const char *service,
       int fd = -1;
       int af = AF_UNSPEC;
 
+      /* Source addresses are cached while the network configuration
+	 is unchanged.  */
+      uint32_t timestamp = __check_pf_timestamp ();
+
       for (i = 0, q = p; q != NULL; ++i, last = q, q = q->ai_next)
 	{
 	  results[i].dest_addr = q;
@@ -2331,6 +2424,10 @@ getaddrinfo (const char *name, const char *service,
 	      results[i].prefixlen = results[i - 1].prefixlen;
 	      results[i].index = results[i - 1].index;
 	    }
+	  else if (srccache_lookup (timestamp, q, &results[i]))
+	    {
+	      /* Found in the cache.  */
+	    }
 	  else
 	    {
 	      results[i].got_source_addr = false;
@@ -2428,6 +2525,8 @@ getaddrinfo (const char *name, const char *service,
 			      &sin6->sin6_addr.s6_addr32[3], INADDRSZ);
 		      results[i].source_addr_len = sizeof (struct sockaddr_in);
 		    }
+
+		  srccache_store (timestamp, q, &results[i]);
 		}
 	      else if (errno == EAFNOSUPPORT && af == AF_INET6
 		       && q->ai_family == AF_INET)
@@ -23,10 +23,16 @@
 
 #include <not-cancel.h>
 
+#if HAVE_TUNABLES
+# define TUNABLE_NAMESPACE dirent
+# include <elf/dl-tunables.h>
+#endif
+
 /* The st_blksize value of the directory is used as a hint for the
    size of the buffer which receives struct dirent values from the
    kernel.  st_blksize is limited to MAX_DIR_BUFFER_SIZE, in case the
-   file system provides a bogus value.  */
+   file system provides a bogus value.  The glibc.dirent.buffer_size
+   tunable overrides the hint.  */
 #define MAX_DIR_BUFFER_SIZE 1048576U
 
 enum {
@@ -114,6 +120,11 @@ __alloc_dir (int fd, bool close_fd, int flags, const struct stat64 *statp)
     allocation = MIN (MAX ((size_t) statp->st_blksize, default_allocation),
 		      MAX_DIR_BUFFER_SIZE);
 #endif
+#if HAVE_TUNABLES
+  size_t buffer_size = TUNABLE_GET (buffer_size, size_t, NULL);
+  if (buffer_size != 0)
+    allocation = MAX (buffer_size, sizeof (struct dirent64));
+#endif
 
   DIR *dirp = (DIR *) malloc (sizeof (DIR) + allocation);
   if (dirp == NULL)
@@ -28,6 +28,13 @@ __BEGIN_DECLS
    directory), and -1 for failure.  */
 extern __ssize_t getdents64 (int __fd, void *__buffer, size_t __length)
   __THROW __nonnull ((2));
+
+/* Read as many entries from the directory stream DIRP as fit into
+   LENGTH bytes at BUFFER, as a sequence of struct dirent64 records.
+   Return the number of bytes used on success (0 for end of directory),
+   and -1 for failure.  */
+extern __ssize_t readdir_batch (DIR *__dirp, void *__buffer, size_t __length)
+  __nonnull ((1, 2));
 #endif
 
 __END_DECLS
@@ -361,6 +361,14 @@ __check_pf (bool *seen_ipv4, bool *seen_ipv6,
   *seen_ipv6 = true;
 }
 
+
+uint32_t
+attribute_hidden
+__check_pf_timestamp (void)
+{
+  return get_nl_timestamp ();
+}
+
 /* Free the cache if it has been allocated.  */
 libc_freeres_fn (freecache)
 {
@@ -0,0 +1,100 @@
+/* Read many directory entries at once.  Linux version.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <dirent.h>
+#include <errno.h>
+#include <string.h>
+
+#include <dirstream.h>
+
+ssize_t
+__readdir_batch (DIR *dirp, void *buffer, size_t length)
+{
+  char *buf = buffer;
+  size_t used = 0;
+  int saved_errno = errno;
+
+  __libc_lock_lock (dirp->lock);
+
+  /* Hand out the entries which are still buffered in DIRP first, so
+     that readdir64 and readdir_batch calls can be mixed.  */
+  while (dirp->offset < dirp->size)
+    {
+      struct dirent64 *dp = (struct dirent64 *) &dirp->data[dirp->offset];
+      size_t reclen = dp->d_reclen;
+
+      if (dp->d_ino != 0)
+	{
+	  if (reclen > length - used)
+	    break;
+	  memcpy (buf + used, dp, reclen);
+	  used += reclen;
+	}
+      dirp->offset += reclen;
+      dirp->filepos = dp->d_off;
+    }
+
+  if (used == 0 && dirp->offset < dirp->size)
+    {
+      /* Not even the next entry fits, which getdents64 also reports
+	 as EINVAL.  */
+      __libc_lock_unlock (dirp->lock);
+      __set_errno (EINVAL);
+      return -1;
+    }
+
+  /* Let the kernel fill the caller's buffer directly.  Try again if
+     all the entries it returned had been deleted.  */
+  while (used == 0)
+    {
+      ssize_t bytes = __getdents64 (dirp->fd, buffer, length);
+      if (bytes <= 0)
+	{
+	  __libc_lock_unlock (dirp->lock);
+	  /* Treat a removed directory like the end of the directory, as
+	     readdir does.  */
+	  if (bytes == 0 || errno == ENOENT)
+	    {
+	      __set_errno (saved_errno);
+	      return 0;
+	    }
+	  return -1;
+	}
+
+      /* Squeeze out deleted entries.  */
+      for (size_t offset = 0; offset < (size_t) bytes; )
+	{
+	  struct dirent64 *dp = (struct dirent64 *) &buf[offset];
+	  size_t reclen = dp->d_reclen;
+
+	  dirp->filepos = dp->d_off;
+	  if (dp->d_ino != 0)
+	    {
+	      if (used != offset)
+		memmove (buf + used, dp, reclen);
+	      used += reclen;
+	    }
+	  offset += reclen;
+	}
+    }
+
+  __libc_lock_unlock (dirp->lock);
+
+  return used;
+}
+weak_alias (__readdir_batch, readdir_batch)
@@ -0,0 +1,141 @@
+/* Test readdir_batch.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/temp_file.h>
+#include <support/xunistd.h>
+
+enum { file_count = 500 };
+
+/* Set to true for each file returned by the stream.  */
+static bool seen[file_count];
+
+static void
+record (const char *name)
+{
+  if (strcmp (name, ".") == 0 || strcmp (name, "..") == 0)
+    return;
+  int i = atoi (name);
+  TEST_VERIFY_EXIT (i >= 0 && i < file_count);
+  TEST_VERIFY (!seen[i]);
+  seen[i] = true;
+}
+
+/* Read the rest of DIRP with readdir_batch and a buffer of LENGTH
+   bytes.  */
+static void
+read_batches (DIR *dirp, size_t length)
+{
+  char *buffer = xmalloc (length);
+  int batches = 0;
+
+  while (true)
+    {
+      ssize_t ret = readdir_batch (dirp, buffer, length);
+      if (ret < 0)
+	FAIL_EXIT1 ("readdir_batch: %m");
+      if (ret == 0)
+	break;
+      ++batches;
+
+      for (char *p = buffer; p < buffer + ret; )
+	{
+	  struct dirent64 *d = (struct dirent64 *) p;
+	  TEST_VERIFY_EXIT (d->d_reclen <= buffer + ret - p);
+	  TEST_VERIFY (d->d_ino != 0);
+	  record (d->d_name);
+	  p += d->d_reclen;
+	}
+    }
+
+  /* The end of the directory is sticky.  */
+  TEST_COMPARE (readdir_batch (dirp, buffer, length), 0);
+  if (length < 4096)
+    TEST_VERIFY (batches > 1);
+  free (buffer);
+}
+
+static void
+check_all_seen (void)
+{
+  for (int i = 0; i < file_count; ++i)
+    {
+      if (!seen[i])
+	{
+	  support_record_failure ();
+	  printf ("error: file %d not returned\n", i);
+	}
+      seen[i] = false;
+    }
+}
+
+static int
+do_test (void)
+{
+  char *dir = support_create_temp_directory ("tst-readdir_batch-");
+  for (int i = 0; i < file_count; ++i)
+    {
+      char *name = xasprintf ("%s/%d", dir, i);
+      xclose (xopen (name, O_WRONLY | O_CREAT, 0600));
+      add_temp_file (name);
+      free (name);
+    }
+
+  DIR *dirp = opendir (dir);
+  TEST_VERIFY_EXIT (dirp != NULL);
+
+  /* Small and large buffers.  */
+  read_batches (dirp, 1024);
+  check_all_seen ();
+  rewinddir (dirp);
+  read_batches (dirp, 1024 * 1024);
+  check_all_seen ();
+
+  /* Entries already buffered for readdir64 come first.  */
+  rewinddir (dirp);
+  for (int i = 0; i < 10; ++i)
+    {
+      struct dirent64 *d = readdir64 (dirp);
+      TEST_VERIFY_EXIT (d != NULL);
+      record (d->d_name);
+    }
+  read_batches (dirp, 2048);
+  check_all_seen ();
+
+  /* A buffer which cannot hold a single entry.  */
+  rewinddir (dirp);
+  TEST_VERIFY_EXIT (readdir64 (dirp) != NULL);
+  char small[8];
+  errno = 0;
+  TEST_COMPARE (readdir_batch (dirp, small, sizeof (small)), -1);
+  TEST_COMPARE (errno, EINVAL);
+
+  TEST_COMPARE (closedir (dirp), 0);
+  free (dir);
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,24 @@
+/* Reference to the IFUNC symbol in tst-ifunc-cache-mod.so.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <string.h>
+
+extern int tst_ifunc_cache_fn (void);
+
+int (*tst_ifunc_cache_modb_fn) (void) = tst_ifunc_cache_fn;
+__typeof__ (memcpy) *tst_ifunc_cache_modb_memcpy = memcpy;
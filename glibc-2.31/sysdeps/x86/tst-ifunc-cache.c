@@ -0,0 +1,90 @@
+/* Test memoization of IFUNC resolver results during relocation.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* tst-ifunc-cache-moda.so and tst-ifunc-cache-modb.so both refer to
+   memcpy in libc, whose resolver result is cached, and to the IFUNC
+   symbol defined in tst-ifunc-cache-mod.so, whose resolver counts its
+   calls.  Only the resolvers of libc and ld.so are cached, so the
+   counting resolver must run for each reference, also after all three
+   objects are unloaded and tst-ifunc-cache-mod.so is loaded again.  */
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/xdlfcn.h>
+
+typedef int (*fn_type) (void);
+typedef __typeof__ (memcpy) *memcpy_type;
+
+/* Open tst-ifunc-cache-mod<SUFFIX>.so and return the value of the
+   function pointer it initializes from the IFUNC symbol.  Check the
+   pointer it initializes from memcpy against MEMCPY_FN.  */
+static fn_type
+open_user (const char *suffix, void **handle, memcpy_type memcpy_fn)
+{
+  char name[64];
+  snprintf (name, sizeof (name), "tst-ifunc-cache-mod%s.so", suffix);
+  *handle = xdlopen (name, RTLD_NOW);
+  snprintf (name, sizeof (name), "tst_ifunc_cache_mod%s_memcpy", suffix);
+  TEST_VERIFY (*(memcpy_type *) xdlsym (*handle, name) == memcpy_fn);
+  snprintf (name, sizeof (name), "tst_ifunc_cache_mod%s_fn", suffix);
+  fn_type fn = *(fn_type *) xdlsym (*handle, name);
+  TEST_COMPARE (fn (), 42);
+  return fn;
+}
+
+static int
+do_test (void)
+{
+  /* dlsym calls the resolver itself, without the cache.  */
+  memcpy_type memcpy_fn = xdlsym (RTLD_DEFAULT, "memcpy");
+
+  void *previous_calls = NULL;
+  for (int round = 0; round < 2; ++round)
+    {
+      void *mod = xdlopen ("tst-ifunc-cache-mod.so", RTLD_NOW);
+      int *calls = xdlsym (mod, "tst_ifunc_cache_resolver_calls");
+      TEST_COMPARE (*calls, 0);
+
+      /* Do not use dlsym on the IFUNC symbol, which would call the
+	 resolver.  */
+      if (round > 0)
+	printf ("info: tst-ifunc-cache-mod.so %s its address\n",
+		(void *) calls == previous_calls
+		? "reused" : "did not reuse");
+      previous_calls = calls;
+
+      /* The resolver with side effects runs for each reference.  */
+      void *moda;
+      fn_type fna = open_user ("a", &moda, memcpy_fn);
+      TEST_COMPARE (*calls, 1);
+      void *modb;
+      fn_type fnb = open_user ("b", &modb, memcpy_fn);
+      TEST_COMPARE (*calls, 2);
+      TEST_VERIFY (fna == fnb);
+
+      xdlclose (modb);
+      xdlclose (moda);
+      xdlclose (mod);
+    }
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -26,6 +26,7 @@
 #include <sysdep.h>
 #include <tls.h>
 #include <dl-tlsdesc.h>
+#include <dl-ifunc-cache.h>
 #include <cpu-features.c>
 
 /* Return nonzero iff ELF header is compatible with the running host.  */
@@ -327,7 +328,12 @@ elf_machine_rela (struct link_map *map, const ElfW(Rela) *reloc,
 				strtab + refsym->st_name);
 	    }
 # endif
-	  value = ((ElfW(Addr) (*) (void)) value) ();
+	  /* Do not cache the result of a resolver which runs before its
+	     object is relocated, it may be wrong.  */
+	  if (sym_map != map && !sym_map->l_relocated)
+	    value = ((ElfW(Addr) (*) (void)) value) ();
+	  else
+	    value = _dl_ifunc_cache_call (sym_map, value);
 	}
 
       switch (r_type)
@@ -513,7 +519,7 @@ elf_machine_rela (struct link_map *map, const ElfW(Rela) *reloc,
 	case R_X86_64_IRELATIVE:
 	  value = map->l_addr + reloc->r_addend;
 	  if (__glibc_likely (!skip_ifunc))
-	    value = ((ElfW(Addr) (*) (void)) value) ();
+	    value = _dl_ifunc_cache_call (map, value);
 	  *reloc_addr = value;
 	  break;
 	default:
@@ -576,7 +582,7 @@ elf_machine_lazy_rel (struct link_map *map,
     {
       ElfW(Addr) value = map->l_addr + reloc->r_addend;
       if (__glibc_likely (!skip_ifunc))
-	value = ((ElfW(Addr) (*) (void)) value) ();
+	value = _dl_ifunc_cache_call (map, value);
       *reloc_addr = value;
     }
   else
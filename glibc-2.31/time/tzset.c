@@ -123,6 +123,10 @@ __tzstring (const char *s)
 
 static char *old_tz;
 
+/* A copy of the string from which the rules in tz_rules were parsed,
+   if they have not been replaced since, otherwise NULL.  */
+static char *tz_rules_string;
+
 static void
 update_vars (void)
 {
@@ -320,6 +324,19 @@ parse_rule (const char **tzp, int whichrule)
 void
 __tzset_parse_tz (const char *tz)
 {
+  /* __tzfile_compute passes the TZ string of the time zone file for
+     each conversion after the last transition.  Do not parse it again
+     if the rules are still in place, which also keeps the transition
+     times computed for the current year.  */
+  if (tz_rules_string != NULL && strcmp (tz, tz_rules_string) == 0)
+    {
+      update_vars ();
+      return;
+    }
+  free (tz_rules_string);
+  tz_rules_string = NULL;
+  const char *string = tz;
+
   /* Clear out old state and reset to unnamed UTC.  */
   memset (tz_rules, '\0', sizeof tz_rules);
   tz_rules[0].name = tz_rules[1].name = "";
@@ -360,6 +377,7 @@ __tzset_parse_tz (const char *tz)
     }
 
   update_vars ();
+  tz_rules_string = __strdup (string);
 }
 
 /* Interpret the TZ envariable.  */
@@ -396,6 +414,8 @@ tzset_internal (int always)
 
   tz_rules[0].name = NULL;
   tz_rules[1].name = NULL;
+  free (tz_rules_string);
+  tz_rules_string = NULL;
 
   /* Save the value of `tz'.  */
   free (old_tz);
@@ -621,4 +641,6 @@ libc_freeres_fn (free_mem)
     }
   free (old_tz);
   old_tz = NULL;
+  free (tz_rules_string);
+  tz_rules_string = NULL;
 }
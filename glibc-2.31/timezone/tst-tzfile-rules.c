@@ -0,0 +1,110 @@
+/* Test local time conversion with the rules of time zone files.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <stdlib.h>
+#include <support/check.h>
+#include <time.h>
+
+/* Times after the last transition in the files are converted with
+   the TZ string at their end, which is kept parsed across calls.
+   Alternate between such times and earlier ones to check that the
+   results and the tzname variable do not depend on the previous
+   call.  */
+
+struct zone
+{
+  const char *name;
+  const char *std;
+  const char *dst;
+  long int stdoff;
+  long int dstoff;
+  /* True if DST is in effect in January.  */
+  int southern;
+};
+
+static const struct zone zones[] =
+  {
+    { "America/New_York", "EST", "EDT", -5 * 3600, -4 * 3600, 0 },
+    { "Australia/Melbourne", "AEST", "AEDT", 10 * 3600, 11 * 3600, 1 },
+    { "Europe/Berlin", "CET", "CEST", 1 * 3600, 2 * 3600, 0 },
+  };
+
+static time_t
+make_time (int year, int month)
+{
+  struct tm tm = { .tm_year = year - 1900, .tm_mon = month - 1,
+		   .tm_mday = 15, .tm_hour = 12 };
+  return timegm (&tm);
+}
+
+static void
+check (const struct zone *z, int year, int month)
+{
+  time_t t = make_time (year, month);
+  int isdst = (month == 1) == z->southern;
+
+  struct tm *tm = localtime (&t);
+  TEST_VERIFY_EXIT (tm != NULL);
+  TEST_COMPARE (tm->tm_isdst, isdst);
+  TEST_COMPARE (tm->tm_gmtoff, isdst ? z->dstoff : z->stdoff);
+  TEST_COMPARE_STRING (tm->tm_zone, isdst ? z->dst : z->std);
+  TEST_COMPARE_STRING (tzname[0], z->std);
+  TEST_COMPARE_STRING (tzname[1], z->dst);
+  TEST_COMPARE (mktime (tm), t);
+
+  struct tm tm_r;
+  TEST_VERIFY_EXIT (localtime_r (&t, &tm_r) != NULL);
+  TEST_COMPARE (tm_r.tm_isdst, isdst);
+  TEST_COMPARE (tm_r.tm_hour, 12 + tm_r.tm_gmtoff / 3600);
+}
+
+static int
+do_test (void)
+{
+  if (sizeof (time_t) < 8)
+    FAIL_UNSUPPORTED ("time_t cannot represent times after 2038");
+
+  for (int i = 0; i < 2; ++i)
+    for (size_t j = 0; j < sizeof (zones) / sizeof (zones[0]); ++j)
+      {
+	setenv ("TZ", zones[j].name, 1);
+	tzset ();
+	for (int k = 0; k < 3; ++k)
+	  {
+	    check (&zones[j], 2100, 1);
+	    check (&zones[j], 2010, 7);
+	    check (&zones[j], 2100, 7);
+	    check (&zones[j], 2010, 1);
+	    check (&zones[j], 2101, 1);
+	    check (&zones[j], 2101, 7);
+	  }
+
+	/* A rule string in TZ replaces the rules of the file.  */
+	setenv ("TZ", "STD-1DST,M3.5.0,M10.5.0", 1);
+	tzset ();
+	time_t t = make_time (2100, 7);
+	struct tm *tm = localtime (&t);
+	TEST_VERIFY_EXIT (tm != NULL);
+	TEST_COMPARE_STRING (tm->tm_zone, "DST");
+	TEST_COMPARE (tm->tm_gmtoff, 2 * 3600);
+      }
+
+  return 0;
+}
+
+#include <support/test-driver.c>
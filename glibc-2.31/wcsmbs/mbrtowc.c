@@ -62,6 +62,14 @@ __mbrtowc (wchar_t *pwc, const char *s, size_t n, mbstate_t *ps)
   if (n == 0)
     return (size_t) -2;
 
+  /* All charsets used for locales are ASCII compatible, see btowc, so
+     in the initial state an ASCII byte is the character itself.  */
+  if (__mbsinit (data.__statep) && (unsigned char) *s < 0x80)
+    {
+      *(wchar_t *) outbuf = (unsigned char) *s;
+      return *s != '\0';
+    }
+
   /* Tell where we want the result.  */
   data.__outbuf = outbuf;
   data.__outbufend = outbuf + sizeof (wchar_t);
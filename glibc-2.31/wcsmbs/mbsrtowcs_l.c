@@ -64,13 +64,45 @@ __mbsrtowcs_l (wchar_t *dst, const char **src, size_t len, mbstate_t *ps,
     PTR_DEMANGLE (fct);
 #endif
 
+  /* All charsets used for locales are ASCII compatible, see btowc.
+     In the initial state the leading ASCII characters can therefore be
+     converted without calling into the conversion step.  */
+  size_t nascii = 0;
+  if (__mbsinit (data.__statep))
+    {
+      const unsigned char *s = (const unsigned char *) *src;
+
+      if (dst == NULL)
+	{
+	  while (s[nascii] != '\0' && s[nascii] < 0x80)
+	    ++nascii;
+	  if (s[nascii] == '\0')
+	    return nascii;
+	}
+      else
+	{
+	  for (; nascii < len && s[nascii] < 0x80; ++nascii)
+	    if ((dst[nascii] = s[nascii]) == L'\0')
+	      {
+		*src = NULL;
+		return nascii;
+	      }
+
+	  *src += nascii;
+	  if (nascii == len)
+	    return nascii;
+	  dst += nascii;
+	  len -= nascii;
+	}
+    }
+
   /* We have to handle DST == NULL special.  */
   if (dst == NULL)
     {
       mbstate_t temp_state;
       wchar_t buf[64];		/* Just an arbitrary size.  */
-      const unsigned char *inbuf = (const unsigned char *) *src;
-      const unsigned char *srcend = inbuf + strlen (*src) + 1;
+      const unsigned char *inbuf = (const unsigned char *) *src + nascii;
+      const unsigned char *srcend = inbuf + strlen ((const char *) inbuf) + 1;
 
       temp_state = *data.__statep;
       data.__statep = &temp_state;
@@ -158,6 +190,8 @@ __mbsrtowcs_l (wchar_t *dst, const char **src, size_t len, mbstate_t *ps,
       result = (size_t) -1;
       __set_errno (EILSEQ);
     }
+  else
+    result += nascii;
 
   return result;
 }
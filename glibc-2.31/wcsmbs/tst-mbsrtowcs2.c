@@ -0,0 +1,112 @@
+/* Test ASCII handling of mbsrtowcs, wcsrtombs and mbrtowc.
+   Copyright (C) 2020 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <locale.h>
+#include <string.h>
+#include <wchar.h>
+#include <support/check.h>
+
+static int
+do_test (void)
+{
+  TEST_VERIFY_EXIT (setlocale (LC_ALL, "de_DE.UTF-8") != NULL);
+
+  /* An ASCII prefix followed by a two byte sequence.  */
+  const char mb[] = "abcdef\xc3\xa4xyz";
+  const wchar_t wc[] = L"abcdef\xe4xyz";
+  mbstate_t state;
+  wchar_t wbuf[16];
+  char buf[16];
+  const char *mbp;
+  const wchar_t *wcp;
+
+  /* Only counting.  */
+  memset (&state, '\0', sizeof (state));
+  mbp = mb;
+  TEST_COMPARE (mbsrtowcs (NULL, &mbp, 0, &state), 10);
+  TEST_VERIFY (mbp == mb);
+  memset (&state, '\0', sizeof (state));
+  wcp = wc;
+  TEST_COMPARE (wcsrtombs (NULL, &wcp, 0, &state), 11);
+  TEST_VERIFY (wcp == wc);
+
+  /* The output buffer ends within the ASCII prefix.  */
+  memset (&state, '\0', sizeof (state));
+  mbp = mb;
+  TEST_COMPARE (mbsrtowcs (wbuf, &mbp, 4, &state), 4);
+  TEST_VERIFY (mbp == mb + 4);
+  TEST_VERIFY (wmemcmp (wbuf, wc, 4) == 0);
+  memset (&state, '\0', sizeof (state));
+  wcp = wc;
+  TEST_COMPARE (wcsrtombs (buf, &wcp, 4, &state), 4);
+  TEST_VERIFY (wcp == wc + 4);
+  TEST_VERIFY (memcmp (buf, mb, 4) == 0);
+
+  /* The output buffer ends right after the prefix.  */
+  memset (&state, '\0', sizeof (state));
+  mbp = mb;
+  TEST_COMPARE (mbsrtowcs (wbuf, &mbp, 7, &state), 7);
+  TEST_VERIFY (mbp == mb + 8);
+  TEST_VERIFY (wmemcmp (wbuf, wc, 7) == 0);
+  memset (&state, '\0', sizeof (state));
+  wcp = wc;
+  TEST_COMPARE (wcsrtombs (buf, &wcp, 7, &state), 6);
+  TEST_VERIFY (wcp == wc + 6);
+
+  /* The whole string.  */
+  memset (&state, '\0', sizeof (state));
+  mbp = mb;
+  TEST_COMPARE (mbsrtowcs (wbuf, &mbp, 16, &state), 10);
+  TEST_VERIFY (mbp == NULL);
+  TEST_VERIFY (wmemcmp (wbuf, wc, 11) == 0);
+  memset (&state, '\0', sizeof (state));
+  wcp = wc;
+  TEST_COMPARE (wcsrtombs (buf, &wcp, 16, &state), 11);
+  TEST_VERIFY (wcp == NULL);
+  TEST_VERIFY (memcmp (buf, mb, 12) == 0);
+
+  /* A pure ASCII string.  */
+  memset (&state, '\0', sizeof (state));
+  mbp = "hello";
+  TEST_COMPARE (mbsrtowcs (wbuf, &mbp, 16, &state), 5);
+  TEST_VERIFY (mbp == NULL);
+  TEST_VERIFY (wcscmp (wbuf, L"hello") == 0);
+
+  /* An invalid sequence after the prefix.  */
+  memset (&state, '\0', sizeof (state));
+  mbp = "abc\xff";
+  TEST_COMPARE (mbsrtowcs (wbuf, &mbp, 16, &state), (size_t) -1);
+  TEST_COMPARE (errno, EILSEQ);
+
+  /* An ASCII byte within a multibyte sequence is not a character.  */
+  memset (&state, '\0', sizeof (state));
+  wchar_t w = L'x';
+  TEST_COMPARE (mbrtowc (&w, "\xc3", 1, &state), (size_t) -2);
+  TEST_COMPARE (mbrtowc (&w, "a", 1, &state), (size_t) -1);
+  TEST_COMPARE (errno, EILSEQ);
+  memset (&state, '\0', sizeof (state));
+  TEST_COMPARE (mbrtowc (&w, "a", 1, &state), 1);
+  TEST_COMPARE (w, L'a');
+  TEST_COMPARE (mbrtowc (&w, "", 1, &state), 0);
+  TEST_COMPARE (w, L'\0');
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -19,6 +19,7 @@
 #include <assert.h>
 #include <dlfcn.h>
 #include <errno.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <gconv.h>
 #include <wchar.h>
@@ -60,13 +61,45 @@ __wcsrtombs (char *dst, const wchar_t **src, size_t len, mbstate_t *ps)
     PTR_DEMANGLE (fct);
 #endif
 
+  /* All charsets used for locales are ASCII compatible, see btowc.
+     In the initial state the leading ASCII characters can therefore be
+     converted without calling into the conversion step.  */
+  size_t nascii = 0;
+  if (__mbsinit (data.__statep))
+    {
+      const wchar_t *s = *src;
+
+      if (dst == NULL)
+	{
+	  while (s[nascii] != L'\0' && (uint32_t) s[nascii] < 0x80)
+	    ++nascii;
+	  if (s[nascii] == L'\0')
+	    return nascii;
+	}
+      else
+	{
+	  for (; nascii < len && (uint32_t) s[nascii] < 0x80; ++nascii)
+	    if ((dst[nascii] = s[nascii]) == '\0')
+	      {
+		*src = NULL;
+		return nascii;
+	      }
+
+	  *src += nascii;
+	  if (nascii == len)
+	    return nascii;
+	  dst += nascii;
+	  len -= nascii;
+	}
+    }
+
   /* We have to handle DST == NULL special.  */
   if (dst == NULL)
     {
       mbstate_t temp_state;
       unsigned char buf[256];		/* Just an arbitrary value.  */
-      const wchar_t *srcend = *src + __wcslen (*src) + 1;
-      const unsigned char *inbuf = (const unsigned char *) *src;
+      const wchar_t *srcend = *src + nascii + __wcslen (*src + nascii) + 1;
+      const unsigned char *inbuf = (const unsigned char *) (*src + nascii);
       size_t dummy;
 
       temp_state = *data.__statep;
@@ -139,6 +172,8 @@ __wcsrtombs (char *dst, const wchar_t **src, size_t len, mbstate_t *ps)
       result = (size_t) -1;
       __set_errno (EILSEQ);
     }
+  else
+    result += nascii;
 
   return result;
 }